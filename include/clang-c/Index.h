@@ -32,7 +32,7 @@
  * compatible, thus CINDEX_VERSION_MAJOR is expected to remain stable.
  */
 #define CINDEX_VERSION_MAJOR 0
-#define CINDEX_VERSION_MINOR 50
+#define CINDEX_VERSION_MINOR 51
 
 #define CINDEX_VERSION_ENCODE(major, minor) ( \
       ((major) * 10000)                       \
@@ -1341,7 +1341,20 @@ enum CXTranslationUnit_Flags {
   /**
    * Used to indicate that implicit attributes should be visited.
    */
-  CXTranslationUnit_VisitImplicitAttributes = 0x2000
+  CXTranslationUnit_VisitImplicitAttributes = 0x2000,
+
+  /**
+   * Used to indicate that the precompiled preamble of the translation unit
+   * may be shared with other translation units of the same index that are
+   * parsed with this flag.
+   *
+   * Translation units whose main files are in the same directory, start with
+   * the same preamble and are compiled with the same options then use a
+   * single precompiled preamble, and a preamble that starts with the
+   * preamble of another translation unit is built on top of it. This only
+   * has an effect in combination with CXTranslationUnit_PrecompiledPreamble.
+   */
+  CXTranslationUnit_SharePreamble = 0x4000
 };
 
 /**
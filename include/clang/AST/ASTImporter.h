@@ -140,7 +140,7 @@ class Attr;
     /// "to" context.
     ///
     /// \returns the equivalent attribute in the "to" context.
-    Attr *Import(const Attr *FromAttr);
+    virtual Attr *Import(const Attr *FromAttr);
 
     /// Import the given declaration from the "from" context into the
     /// "to" context.
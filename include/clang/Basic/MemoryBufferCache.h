@@ -10,6 +10,7 @@
 #ifndef LLVM_CLANG_BASIC_MEMORYBUFFERCACHE_H
 #define LLVM_CLANG_BASIC_MEMORYBUFFERCACHE_H
 
+#include "clang/Basic/SharedModuleCache.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/StringMap.h"
 #include <memory>
@@ -29,9 +30,12 @@ namespace clang {
 /// \a finalizeCurrentBuffers() should be called before creating a new user.
 /// This locks in the current buffers, ensuring that no buffer that has already
 /// been accessed can be purged, preventing use-after-frees.
+///
+/// Optionally, buffers can also be shared with other compilations in the same
+/// process through a \a SharedModuleCache.
 class MemoryBufferCache : public llvm::RefCountedBase<MemoryBufferCache> {
   struct BufferEntry {
-    std::unique_ptr<llvm::MemoryBuffer> Buffer;
+    std::shared_ptr<llvm::MemoryBuffer> Buffer;
 
     /// Track the timeline of when this was added to the cache.
     unsigned Index;
@@ -46,6 +50,9 @@ class MemoryBufferCache : public llvm::RefCountedBase<MemoryBufferCache> {
   /// Bumped to prevent "older" buffers from being removed.
   unsigned FirstRemovableIndex = 0;
 
+  /// The process-wide cache shared with other compilations, if any.
+  llvm::IntrusiveRefCntPtr<SharedModuleCache> SharedCache;
+
 public:
   /// Store the Buffer under the Filename.
   ///
@@ -54,8 +61,18 @@ public:
   llvm::MemoryBuffer &addBuffer(llvm::StringRef Filename,
                                 std::unique_ptr<llvm::MemoryBuffer> Buffer);
 
+  /// Store a buffer that may also be owned by others (e.g. a buffer from the
+  /// \a SharedModuleCache) under the Filename.
+  ///
+  /// \pre There is not already buffer is not already in the cache.
+  /// \return a reference to the buffer as a convenience.
+  llvm::MemoryBuffer &addBuffer(llvm::StringRef Filename,
+                                std::shared_ptr<llvm::MemoryBuffer> Buffer);
+
   /// Try to remove a buffer from the cache.
   ///
+  /// On success, the buffer is also removed from the shared cache, if any.
+  ///
   /// \return false on success, iff \c !isBufferFinal().
   bool tryToRemoveBuffer(llvm::StringRef Filename);
 
@@ -73,6 +90,14 @@ public:
   /// Should be called when creating a new user to ensure previous uses aren't
   /// invalidated.
   void finalizeCurrentBuffers();
+
+  /// Share buffers with other compilations through \p Cache.
+  void setSharedCache(llvm::IntrusiveRefCntPtr<SharedModuleCache> Cache) {
+    SharedCache = std::move(Cache);
+  }
+
+  /// Get the process-wide cache, if any.
+  SharedModuleCache *getSharedCache() const { return SharedCache.get(); }
 };
 
 } // end namespace clang
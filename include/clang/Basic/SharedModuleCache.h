@@ -0,0 +1,130 @@
+//===- SharedModuleCache.h - Process-wide cache of module files -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_SHAREDMODULECACHE_H
+#define LLVM_CLANG_BASIC_SHAREDMODULECACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/StringMap.h"
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+
+namespace llvm {
+class MemoryBuffer;
+} // end namespace llvm
+
+namespace clang {
+
+/// Share loaded module files between all of the compiler instances in a
+/// process.
+///
+/// A \a MemoryBufferCache only lives as long as a single compilation, so a
+/// server or a multi-threaded tool that compiles many translation units would
+/// otherwise re-read every PCM it imports once per translation unit. Setting
+/// a \a SharedModuleCache on each \a MemoryBufferCache lets the \a
+/// ModuleManager reuse buffers read by other compilations, along with the
+/// time at which they were last found to be up to date.
+///
+/// Buffers are keyed by file name, and are only handed out while the size and
+/// modification time of the file match those the buffer was read with. Users
+/// share ownership of the buffers they get, so entries can be evicted at any
+/// time; once the total size of the cached buffers exceeds the memory budget,
+/// the least recently used ones are dropped.
+///
+/// All operations are thread-safe.
+class SharedModuleCache
+    : public llvm::ThreadSafeRefCountedBase<SharedModuleCache> {
+  struct CacheEntry {
+    std::shared_ptr<llvm::MemoryBuffer> Buffer;
+
+    /// Size and modification time of the file the buffer was read from.
+    off_t Size;
+    time_t ModTime;
+
+    /// When the module file's inputs were last validated, or 0 if they
+    /// never were.
+    time_t ValidationTime;
+
+    /// Tick of the last lookup or insertion of this entry.
+    uint64_t LastUse;
+  };
+
+  mutable std::mutex Mutex;
+
+  llvm::StringMap<CacheEntry> Entries;
+
+  /// The maximum total size of the cached buffers in bytes, or 0 for no
+  /// limit.
+  size_t MemoryBudget;
+
+  /// The total size of the cached buffers in bytes.
+  size_t TotalSize = 0;
+
+  /// Monotonically increasing counter used to order entries by recency.
+  uint64_t CurrentTick = 0;
+
+  unsigned NumHits = 0;
+  unsigned NumMisses = 0;
+  unsigned NumEvictions = 0;
+
+  /// Drop least recently used entries until the cache fits its budget.
+  /// Requires \c Mutex to be held.
+  void evictToBudget();
+
+public:
+  explicit SharedModuleCache(size_t MemoryBudget = 0)
+      : MemoryBudget(MemoryBudget) {}
+
+  /// Look up the buffer for the module file \p Filename.
+  ///
+  /// \param ValidationTime If non-null, set to the time at which the module
+  /// file's inputs were last found to be up to date, or 0.
+  ///
+  /// \returns the buffer, or null if there is none or it was read from a
+  /// file with a different size or modification time.
+  std::shared_ptr<llvm::MemoryBuffer> lookupBuffer(StringRef Filename,
+                                                   off_t Size, time_t ModTime,
+                                                   time_t *ValidationTime =
+                                                       nullptr);
+
+  /// Store the buffer read from the module file \p Filename, replacing any
+  /// other buffer for that file.
+  void addBuffer(StringRef Filename, off_t Size, time_t ModTime,
+                 std::shared_ptr<llvm::MemoryBuffer> Buffer);
+
+  /// Remove the buffer for \p Filename if it is \p Buffer. Another
+  /// compilation may already have replaced it with the buffer of a newer file,
+  /// which stays. Users of the removed buffer keep it alive.
+  void removeBuffer(StringRef Filename, const llvm::MemoryBuffer *Buffer);
+
+  /// Note that the inputs of the module file \p Filename were found to be up
+  /// to date at time \p When.
+  void markValidated(StringRef Filename, time_t When);
+
+  /// Change the memory budget, evicting buffers if necessary.
+  void setMemoryBudget(size_t Budget);
+
+  size_t getMemoryBudget() const;
+
+  /// The total size in bytes of the buffers currently in the cache.
+  size_t getTotalSize() const;
+
+  /// The number of lookups that found an up-to-date buffer.
+  unsigned getNumHits() const;
+
+  /// Print statistics to standard error.
+  void printStats() const;
+};
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_BASIC_SHAREDMODULECACHE_H
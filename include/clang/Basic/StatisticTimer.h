@@ -0,0 +1,45 @@
+//===- StatisticTimer.h - Time operations for statistics --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+/// \file
+/// Defines a helper that measures the time of an operation for statistics.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_STATISTICTIMER_H
+#define LLVM_CLANG_BASIC_STATISTICTIMER_H
+
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Timer.h"
+
+namespace clang {
+
+/// Calls \p Operation and returns its result. When statistics are enabled,
+/// also passes the wall time that \p Operation took, in microseconds, to
+/// \p Record.
+///
+/// Reading the clock is not free, so it is skipped when no statistic would
+/// show the time.
+template <typename OperationT, typename RecordT>
+auto timeForStatistics(OperationT Operation, RecordT Record)
+    -> decltype(Operation()) {
+  if (!llvm::AreStatisticsEnabled())
+    return Operation();
+
+  llvm::TimeRecord Start = llvm::TimeRecord::getCurrentTime(/*Start=*/true);
+  auto Result = Operation();
+  llvm::TimeRecord Elapsed = llvm::TimeRecord::getCurrentTime(/*Start=*/false);
+  Elapsed -= Start;
+  Record(unsigned(Elapsed.getWallTime() * 1e6));
+  return Result;
+}
+
+} // namespace clang
+
+#endif // LLVM_CLANG_BASIC_STATISTICTIMER_H
@@ -87,6 +87,10 @@ public:
 
   /// Create a new \c llvm::Module after calling HandleTranslationUnit. This
   /// enable codegen in interactive processing environments.
+  ///
+  /// Modules created in the same \c llvm::LLVMContext as the previous one
+  /// reuse the LLVM types and layouts of the records converted so far, so
+  /// that context must stay alive as long as this code generator does.
   llvm::Module* StartModule(llvm::StringRef ModuleName, llvm::LLVMContext &C);
 };
 
@@ -60,6 +60,9 @@
 /* Define if we have sys/resource.h (rlimits) */
 #cmakedefine CLANG_HAVE_RLIMITS ${CLANG_HAVE_RLIMITS}
 
+/* Define if we have mallinfo2 */
+#cmakedefine CLANG_HAVE_MALLINFO2 ${CLANG_HAVE_MALLINFO2}
+
 /* The LLVM product name and version */
 #define BACKEND_PACKAGE_STRING "${BACKEND_PACKAGE_STRING}"
 
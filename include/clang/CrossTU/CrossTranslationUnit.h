@@ -18,6 +18,7 @@
 #include "clang/Basic/LLVM.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Error.h"
 
@@ -84,7 +85,9 @@ std::string createCrossTUIndexString(const llvm::StringMap<std::string> &Index);
 /// In order to use this class, an index file is required that describes
 /// the locations of the AST files for each function definition.
 ///
-/// Note that this class also implements caching.
+/// Note that this class also implements caching. Imported definitions are
+/// remembered, so a definition is imported at most once. The loaded external
+/// ASTs can be bounded with setASTMemoryBudget().
 class CrossTranslationUnitContext {
 public:
   CrossTranslationUnitContext(CompilerInstance &CI);
@@ -119,7 +122,8 @@ public:
   /// corresponding AST file will be loaded.
   ///
   /// \return Returns an ASTUnit that contains the definition of the looked up
-  /// function.
+  /// function. If a memory budget is set, the unit may be unloaded by later
+  /// calls.
   ///
   /// Note that the AST files should also be in the \p CrossTUDir.
   llvm::Expected<ASTUnit *> loadExternalAST(StringRef LookupName,
@@ -139,16 +143,45 @@ public:
   /// Emit diagnostics for the user for potential configuration errors.
   void emitCrossTUDiagnostics(const IndexError &IE);
 
+  /// Limit the memory held by the loaded external ASTs to about \p Bytes.
+  /// When loading an AST exceeds the budget, the least recently used other
+  /// ASTs are unloaded. The ASTs that attributes were imported from stay
+  /// loaded, since the importer does not copy the arguments of attributes, so
+  /// the imported declarations may still refer to them. Zero means no limit,
+  /// which is the default.
+  void setASTMemoryBudget(uint64_t Bytes) { ASTMemoryBudget = Bytes; }
+
+  /// Returns the number of external ASTs that are currently loaded.
+  unsigned getNumLoadedASTs() const { return ASTUnitsByUse.size(); }
+
 private:
   ASTImporter &getOrCreateASTImporter(ASTContext &From);
   const FunctionDecl *findFunctionInDeclContext(const DeclContext *DC,
                                                 StringRef LookupFnName);
 
+  /// Mark \p Unit as the most recently used AST.
+  void touchASTUnit(ASTUnit *Unit);
+
+  /// Unload the least recently used ASTs other than \p Keep until the loaded
+  /// ASTs fit into the memory budget.
+  void enforceASTMemoryBudget(const ASTUnit *Keep);
+
+  /// Whether declarations imported from \p Unit may still refer to it.
+  bool isReferredToByImports(const ASTUnit &Unit) const;
+
+  /// Unload \p Unit and forget everything that refers to it.
+  void unloadASTUnit(ASTUnit *Unit);
+
   llvm::StringMap<std::unique_ptr<clang::ASTUnit>> FileASTUnitMap;
   llvm::StringMap<clang::ASTUnit *> FunctionASTUnitMap;
   llvm::StringMap<std::string> FunctionFileMap;
   llvm::DenseMap<TranslationUnitDecl *, std::unique_ptr<ASTImporter>>
       ASTUnitImporterMap;
+  /// The definitions imported so far, keyed by lookup name.
+  llvm::StringMap<const FunctionDecl *> ImportedFunctionMap;
+  /// The loaded ASTs, the least recently used first.
+  llvm::SmallVector<ASTUnit *, 8> ASTUnitsByUse;
+  uint64_t ASTMemoryBudget = 0;
   CompilerInstance &CI;
   ASTContext &Context;
 };
@@ -29,6 +29,7 @@
 #include "clang/Sema/CodeCompleteConsumer.h"
 #include "clang/Serialization/ASTBitCodes.h"
 #include "clang/Frontend/PrecompiledPreamble.h"
+#include "clang/Frontend/PreambleStore.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
@@ -218,7 +219,15 @@ private:
   llvm::StringMap<SourceLocation> PreambleSrcLocCache;
 
   /// The contents of the preamble.
-  llvm::Optional<PrecompiledPreamble> Preamble;
+  std::shared_ptr<const PrecompiledPreamble> Preamble;
+
+  /// The store through which preambles are shared with translation units of
+  /// other main files, if any.
+  std::shared_ptr<PreambleStore> SharedPreambles;
+
+  /// The entry of \c Preamble in \c SharedPreambles, if it has been shared.
+  /// Keeps the entry alive in the store.
+  std::shared_ptr<const PreambleStore::Entry> SharedPreambleEntry;
 
   /// When non-NULL, this is the buffer used to store the contents of
   /// the main file when it has been padded for use with the precompiled
@@ -488,6 +497,13 @@ public:
   bool getOwnsRemappedFileBuffers() const { return OwnsRemappedFileBuffers; }
   void setOwnsRemappedFileBuffers(bool val) { OwnsRemappedFileBuffers = val; }
 
+  /// Share the preamble of this translation unit with translation units of
+  /// other main files through \p Store. Takes effect the next time the
+  /// preamble is built.
+  void setPreambleStore(std::shared_ptr<PreambleStore> Store) {
+    SharedPreambles = std::move(Store);
+  }
+
   StringRef getMainFileName() const;
 
   /// If this ASTUnit came from an AST file, returns the filename for it.
@@ -803,6 +819,9 @@ public:
   /// for it to be loaded correctly, VFS should have access to it(i.e., be an
   /// overlay over RealFileSystem). RealFileSystem will be used if \p VFS is nullptr.
   ///
+  /// \param SharedPreambles - If non-null, the store through which the
+  /// preamble is shared with translation units of other main files.
+  ///
   // FIXME: Move OnlyLocalDecls, UseBumpAllocator to setters on the ASTUnit, we
   // shouldn't need to specify them at construction time.
   static ASTUnit *LoadFromCommandLine(
@@ -823,7 +842,8 @@ public:
       bool ForSerialization = false,
       llvm::Optional<StringRef> ModuleFormat = llvm::None,
       std::unique_ptr<ASTUnit> *ErrAST = nullptr,
-      IntrusiveRefCntPtr<vfs::FileSystem> VFS = nullptr);
+      IntrusiveRefCntPtr<vfs::FileSystem> VFS = nullptr,
+      std::shared_ptr<PreambleStore> SharedPreambles = nullptr);
 
   /// Reparse the source files using the same command-line options that
   /// were originally used to produce this translation unit.
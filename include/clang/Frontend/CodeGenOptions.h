@@ -212,6 +212,10 @@ public:
   /// Prefix to use for -save-temps output.
   std::string SaveTempsFilePrefix;
 
+  /// The program used to combine the objects generated in parallel under
+  /// -fparallel-codegen into a single object with a partial link.
+  std::string ParallelCodeGenLinker;
+
   /// Name of file passed with -fcuda-include-gpubinary option to forward to
   /// CUDA runtime back-end for incorporating them into host-side object file.
   std::string CudaGpuBinaryFileName;
@@ -0,0 +1,120 @@
+//===--- PreambleStore.h - Share preambles between main files ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Defines the PreambleStore class, which lets translation units of different
+// main files share a precompiled preamble.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_FRONTEND_PREAMBLESTORE_H
+#define LLVM_CLANG_FRONTEND_PREAMBLESTORE_H
+
+#include "clang/Basic/LLVM.h"
+#include "clang/Serialization/ASTBitCodes.h"
+#include "llvm/ADT/StringMap.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+class MemoryBuffer;
+class raw_ostream;
+}
+
+namespace clang {
+namespace vfs {
+class FileSystem;
+}
+
+class CompilerInvocation;
+class PrecompiledPreamble;
+struct PreambleBounds;
+
+/// A store of precompiled preambles that can be shared between translation
+/// units of different main files.
+///
+/// Files of a project often start with the same sequence of #includes and are
+/// compiled with the same flags. Their preambles then produce identical PCHs,
+/// so one preamble can be used for all of them. A file whose preamble starts
+/// with the preamble of another file can also use it as the base of a
+/// preamble built with PrecompiledPreamble::BuildExtension().
+///
+/// Preambles are looked up by the options of the compiler invocation that
+/// affect them, by the directory of the main file, against which quoted
+/// includes are resolved, and by the bytes of the preamble. The bytes are not
+/// normalized in any way, since a preamble is mapped into the main file by
+/// offset.
+///
+/// The store does not keep preambles alive: once the last translation unit
+/// using a preamble releases it, it is dropped from the store.
+///
+/// The store is safe to use from multiple threads.
+class PreambleStore {
+public:
+  /// A preamble and the information a translation unit needs to use it
+  /// without building it. Preambles that produced diagnostics should not be
+  /// shared, as the diagnostics refer to the main file they were built for.
+  struct Entry {
+    std::shared_ptr<const PrecompiledPreamble> Preamble;
+    /// The IDs of the top-level declarations in the preamble, including those
+    /// of the preambles it extends.
+    std::vector<serialization::DeclID> TopLevelDeclIDs;
+    /// The hash of the top-level declarations and macros in the preamble.
+    unsigned TopLevelHash = 0;
+  };
+
+  /// Find a preamble that can be reused as is for \p MainFileBuffer.
+  std::shared_ptr<const Entry>
+  findReusable(const CompilerInvocation &Invocation,
+               const llvm::MemoryBuffer *MainFileBuffer,
+               PreambleBounds Bounds, vfs::FileSystem *VFS);
+
+  /// Find the largest preamble that can be extended to the preamble of
+  /// \p MainFileBuffer, see PrecompiledPreamble::CanExtend().
+  std::shared_ptr<const Entry>
+  findExtendable(const CompilerInvocation &Invocation,
+                 const llvm::MemoryBuffer *MainFileBuffer,
+                 PreambleBounds Bounds, vfs::FileSystem *VFS);
+
+  /// Make \p E available to other translation units compiled with the options
+  /// of \p Invocation.
+  void insert(const CompilerInvocation &Invocation,
+              std::shared_ptr<const Entry> E);
+
+  /// Returns the number of preambles found by findReusable().
+  unsigned getNumReused();
+
+  /// Returns the number of preambles found by findExtendable().
+  unsigned getNumExtended();
+
+  /// Print statistics about the use of the store to \p OS.
+  void printStats(raw_ostream &OS);
+
+private:
+  /// Compute the part of the key of a preamble that depends on the compiler
+  /// invocation.
+  static std::string getInvocationKey(const CompilerInvocation &Invocation);
+
+  /// Returns the live entries for \p Key, dropping the dead ones.
+  std::vector<std::shared_ptr<const Entry>> getLiveEntries(StringRef Key);
+
+  std::mutex Mutex;
+
+  /// The entries, keyed by getInvocationKey().
+  llvm::StringMap<std::vector<std::weak_ptr<const Entry>>> Entries;
+
+  unsigned NumLookups = 0;
+  unsigned NumReused = 0;
+  unsigned NumExtended = 0;
+  unsigned NumInserted = 0;
+};
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_FRONTEND_PREAMBLESTORE_H
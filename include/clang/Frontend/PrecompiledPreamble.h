@@ -73,7 +73,8 @@ public:
   /// \param PCHContainerOps An instance of PCHContainerOperations.
   ///
   /// \param StoreInMemory Store PCH in memory. If false, PCH will be stored in
-  /// a temporary file.
+  /// a temporary file. In-memory preambles are never written to disk, unless
+  /// explicitly requested with \c WriteToFile().
   ///
   /// \param Callbacks A set of callbacks to be executed when building
   /// the preamble.
@@ -84,6 +85,24 @@ public:
         std::shared_ptr<PCHContainerOperations> PCHContainerOps,
         bool StoreInMemory, PreambleCallbacks &Callbacks);
 
+  /// Try to build a PrecompiledPreamble for \p Invocation on top of \p Base,
+  /// which must be extendable to \p Bounds (see CanExtend()).
+  ///
+  /// Only the part of the preamble that follows the preamble of \p Base is
+  /// parsed, and the result is stored as a PCH chained to the PCH of \p
+  /// Base, which is kept alive by the new preamble. This is much cheaper than
+  /// rebuilding the preamble when, e.g., an #include was appended to it.
+  ///
+  /// Parameters are the same as for Build().
+  static llvm::ErrorOr<PrecompiledPreamble>
+  BuildExtension(std::shared_ptr<const PrecompiledPreamble> Base,
+                 const CompilerInvocation &Invocation,
+                 const llvm::MemoryBuffer *MainFileBuffer,
+                 PreambleBounds Bounds, DiagnosticsEngine &Diagnostics,
+                 IntrusiveRefCntPtr<vfs::FileSystem> VFS,
+                 std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+                 bool StoreInMemory, PreambleCallbacks &Callbacks);
+
   PrecompiledPreamble(PrecompiledPreamble &&) = default;
   PrecompiledPreamble &operator=(PrecompiledPreamble &&) = default;
 
@@ -91,8 +110,10 @@ public:
   PreambleBounds getBounds() const;
 
   /// Returns the size, in bytes, that preamble takes on disk or in memory.
-  /// For on-disk preambles returns 0 if filesystem operations fail. Intended to
-  /// be used for logging and debugging purposes only.
+  /// For on-disk preambles returns 0 if filesystem operations fail. For
+  /// preambles built with BuildExtension() this does not include the size of
+  /// the base preamble. Intended to be used for logging and debugging purposes
+  /// only.
   std::size_t getSize() const;
 
   /// Check whether PrecompiledPreamble can be reused for the new contents(\p
@@ -101,6 +122,20 @@ public:
                 const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
                 vfs::FileSystem *VFS) const;
 
+  /// Check whether PrecompiledPreamble can be used as the base of a
+  /// preamble for the new contents(\p MainFileBuffer) of the main file, built
+  /// with BuildExtension(). This is the case if the old preamble is a proper
+  /// prefix of the new one that ends at the start of a line, and none of the
+  /// files used by the old preamble have changed.
+  bool CanExtend(const CompilerInvocation &Invocation,
+                 const llvm::MemoryBuffer *MainFileBuffer,
+                 PreambleBounds Bounds, vfs::FileSystem *VFS) const;
+
+  /// Write the PCH of this preamble to \p Path, e.g. to keep an in-memory
+  /// preamble for a later session. Preambles built with BuildExtension()
+  /// depend on their base and cannot be written out.
+  std::error_code WriteToFile(StringRef Path) const;
+
   /// Changes options inside \p CI to use PCH from this preamble. Also remaps
   /// main file to \p MainFileBuffer and updates \p VFS to ensure the preamble
   /// is accessible.
@@ -123,7 +158,21 @@ public:
 private:
   PrecompiledPreamble(PCHStorage Storage, std::vector<char> PreambleBytes,
                       bool PreambleEndsAtStartOfLine,
-                      llvm::StringMap<PreambleFileHash> FilesInPreamble);
+                      llvm::StringMap<PreambleFileHash> FilesInPreamble,
+                      std::shared_ptr<const PrecompiledPreamble> Base);
+
+  static llvm::ErrorOr<PrecompiledPreamble>
+  BuildImpl(const CompilerInvocation &Invocation,
+            const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
+            DiagnosticsEngine &Diagnostics,
+            IntrusiveRefCntPtr<vfs::FileSystem> VFS,
+            std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+            bool StoreInMemory, PreambleCallbacks &Callbacks,
+            std::shared_ptr<const PrecompiledPreamble> Base);
+
+  /// Check that none of the files used by the preamble have changed.
+  bool filesInPreambleAreUnchanged(const CompilerInvocation &Invocation,
+                                   vfs::FileSystem *VFS) const;
 
   /// A temp file that would be deleted on destructor call. If destructor is not
   /// called for any reason, the file will be deleted at static objects'
@@ -165,7 +214,13 @@ private:
 
   class InMemoryPreamble {
   public:
-    std::string Data;
+    /// The PCH, as produced by the PCH writer. The byte right past its end is
+    /// a null terminator, which buffers of the PCH rely on.
+    llvm::SmallVector<char, 0> Data;
+    /// The fake path under which the PCH is made available to the compiler.
+    /// Unique for each preamble, as a chained preamble refers to its base by
+    /// path.
+    std::string Path;
   };
 
   class PCHStorage {
@@ -243,6 +298,14 @@ private:
                                    PreprocessorOptions &PreprocessorOpts,
                                    IntrusiveRefCntPtr<vfs::FileSystem> &VFS);
 
+  /// Like setupPreambleStorage, but also makes the PCHs of all base preambles
+  /// accessible.
+  void setupPreambleStorageChain(PreprocessorOptions &PreprocessorOpts,
+                                 IntrusiveRefCntPtr<vfs::FileSystem> &VFS) const;
+
+  /// Returns the path under which the PCH in \p Storage is made accessible.
+  static StringRef getPCHPath(const PCHStorage &Storage);
+
   /// Manages the memory buffer or temporary file that stores the PCH.
   PCHStorage Storage;
   /// Keeps track of the files that were used when computing the
@@ -257,6 +320,9 @@ private:
   std::vector<char> PreambleBytes;
   /// See PreambleBounds::PreambleEndsAtStartOfLine
   bool PreambleEndsAtStartOfLine;
+  /// The preamble whose PCH the PCH of this preamble is chained to, if it was
+  /// built with BuildExtension().
+  std::shared_ptr<const PrecompiledPreamble> Base;
 };
 
 /// A set of callbacks to gather useful information while building a preamble.
@@ -289,7 +355,8 @@ enum class BuildPreambleError {
   CouldntCreateTempFile = 1,
   CouldntCreateTargetInfo,
   BeginSourceFileFailed,
-  CouldntEmitPCH
+  CouldntEmitPCH,
+  BaseCannotBeExtended
 };
 
 class BuildPreambleErrorCategory final : public std::error_category {
@@ -11,6 +11,8 @@
 #define LLVM_CLANG_LEX_PREPROCESSOROPTIONS_H_
 
 #include "clang/Basic/LLVM.h"
+#include "clang/Basic/SharedModuleCache.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSet.h"
 #include <memory>
@@ -167,6 +169,13 @@ public:
   /// build it again.
   std::shared_ptr<FailedModulesSet> FailedModules;
 
+  /// The module file buffers shared with the other compilations in this
+  /// process, if any.
+  ///
+  /// Compiler instances hand this to their \c MemoryBufferCache, so that
+  /// module files read by one compilation need not be read again by another.
+  llvm::IntrusiveRefCntPtr<SharedModuleCache> SharedModuleFiles;
+
 public:
   PreprocessorOptions() : PrecompiledPreambleBytes(0, false) {}
 
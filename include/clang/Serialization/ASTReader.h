@@ -1010,6 +1010,15 @@ private:
   /// Number of visible decl contexts read/total.
   unsigned NumVisibleDeclContextsRead = 0, TotalVisibleDeclContexts = 0;
 
+  /// The number of class, enum and function definitions that were merged
+  /// into an existing definition with the same ODR hash.
+  unsigned NumODRHashMergedDefinitions = 0;
+
+  /// The number of members of merged definitions that were not checked
+  /// against the canonical definition, because the ODR hashes of the two
+  /// definitions already showed that they match.
+  unsigned NumSkippedOdrMergeChecks = 0;
+
   /// Total size of modules, in bits, currently loaded
   uint64_t TotalModulesSizeInBits = 0;
 
@@ -1141,6 +1150,11 @@ private:
   /// when merging implicit instantiations of class templates across modules.
   llvm::DenseMap<DeclContext *, DeclContext *> MergedDeclContexts;
 
+  /// The subset of the keys of \c MergedDeclContexts whose ODR hash matched
+  /// that of the definition they were merged into. Members of these contexts
+  /// that are covered by the ODR hash need no further checking.
+  llvm::SmallPtrSet<DeclContext *, 16> ODRHashMergedDeclContexts;
+
   /// A mapping from canonical declarations of enums to their canonical
   /// definitions. Only populated when using modules in C++.
   llvm::DenseMap<EnumDecl *, EnumDecl *> EnumDefinitions;
@@ -16,6 +16,7 @@
 #ifndef LLVM_CLANG_SERIALIZATION_GLOBALMODULEINDEX_H
 #define LLVM_CLANG_SERIALIZATION_GLOBALMODULEINDEX_H
 
+#include "clang/Basic/Module.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
@@ -87,6 +88,10 @@ class GlobalModuleIndex {
     /// index was built.
     time_t ModTime;
 
+    /// The signature of the module file at the time the global index was
+    /// built, if it had one.
+    ASTFileSignature Signature;
+
     /// The module IDs on which this module directly depends.
     /// FIXME: We don't really need a vector here.
     llvm::SmallVector<unsigned, 4> Dependencies;
@@ -123,6 +128,8 @@ class GlobalModuleIndex {
   GlobalModuleIndex(const GlobalModuleIndex &) = delete;
   GlobalModuleIndex &operator=(const GlobalModuleIndex &) = delete;
 
+  friend class GlobalModuleIndexBuilder;
+
 public:
   ~GlobalModuleIndex();
 
@@ -193,6 +200,12 @@ public:
 
   /// Write a global index into the given
   ///
+  /// If an up-to-date index already exists in \p Path, the information it
+  /// records for module files whose size and modification time have not
+  /// changed is reused, so that only new or modified module files need to be
+  /// read. The new index replaces the old one atomically, so concurrent
+  /// readers always observe either the old or the new index.
+  ///
   /// \param FileMgr The file manager to use to load module files.
   /// \param PCHContainerRdr - The PCHContainerOperations to use for loading and
   /// creating modules.
@@ -294,6 +294,9 @@ private:
   /// \sa getGraphTrimInterval
   Optional<unsigned> GraphTrimInterval;
 
+  /// \sa shouldTrimGraphAggressively
+  Optional<bool> AggressiveGraphTrim;
+
   /// \sa getMaxSymbolComplexity
   Optional<unsigned> MaxSymbolComplexity;
 
@@ -306,12 +309,27 @@ private:
   /// \sa getMaxNodesPerTopLevelFunction
   Optional<unsigned> MaxNodesPerTopLevelFunction;
 
+  /// \sa getMaxTimePerTopLevelFunction
+  Optional<unsigned> MaxTimePerTopLevelFunction;
+
+  /// \sa getMaxMemoryPerTopLevelFunction
+  Optional<unsigned> MaxMemoryPerTopLevelFunction;
+
+  /// \sa getFunctionTimingOutput
+  Optional<StringRef> FunctionTimingOutput;
+
+  /// \sa getResultCacheDir
+  Optional<StringRef> ResultCacheDir;
+
   /// \sa shouldInlineLambdas
   Optional<bool> InlineLambdas;
 
   /// \sa shouldWidenLoops
   Optional<bool> WidenLoops;
 
+  /// \sa shouldMergeStates
+  Optional<bool> MergeStates;
+
   /// \sa shouldUnrollLoops
   Optional<bool> UnrollLoops;
 
@@ -330,9 +348,21 @@ private:
   /// \sa naiveCTUEnabled
   Optional<bool> NaiveCTU;
 
+  /// \sa getCTUASTMemoryBudget
+  Optional<unsigned> CTUASTMemoryBudget;
+
   /// \sa shouldElideConstructors
   Optional<bool> ElideConstructors;
 
+  /// \sa getAnalysisShardCount
+  Optional<unsigned> AnalysisShardCount;
+
+  /// \sa getAnalysisShardIndex
+  Optional<unsigned> AnalysisShardIndex;
+
+  /// \sa hasValidAnalysisShardIndex
+  bool ValidAnalysisShardIndex = true;
+
 
   /// A helper function that retrieves option for a given full-qualified
   /// checker name.
@@ -646,6 +676,15 @@ public:
   /// node reclamation, set the option to "0".
   unsigned getGraphTrimInterval();
 
+  /// Returns true if node reclamation should also remove the nodes of
+  /// convenience transitions made by the engine, such as dead symbol cleanup,
+  /// which are not needed to reconstruct bug paths.
+  ///
+  /// This is controlled by the 'aggressive-graph-trim' config option, which
+  /// accepts the values "true" and "false". It has no effect if
+  /// 'graph-trim-interval' is "0".
+  bool shouldTrimGraphAggressively();
+
   /// Returns the maximum complexity of symbolic constraint (50 by default).
   ///
   /// This is controlled by "-analyzer-config max-symbol-complexity" option.
@@ -670,6 +709,36 @@ public:
   /// This is controlled by the 'max-nodes' config option.
   unsigned getMaxNodesPerTopLevelFunction();
 
+  /// Returns the wall-clock time, in milliseconds, the analyzer may spend
+  /// exploring a top level function (for each exploded graph). Exploration
+  /// stops as if the node limit was reached. 0 (no limit) is default.
+  ///
+  /// This is controlled by the 'max-time-per-function' config option.
+  unsigned getMaxTimePerTopLevelFunction();
+
+  /// Returns the memory, in megabytes, the exploded graph and the program
+  /// states of a top level function may take. Exploration stops as if the
+  /// node limit was reached. 0 (no limit) is default.
+  ///
+  /// This is controlled by the 'max-memory-per-function' config option.
+  unsigned getMaxMemoryPerTopLevelFunction();
+
+  /// Returns the file to which the time, the number of nodes and the memory
+  /// spent on each top level function are written, as comma-separated values.
+  /// Empty (no output) is default.
+  ///
+  /// This is controlled by the 'function-timing-output' config option.
+  StringRef getFunctionTimingOutput();
+
+  /// Returns the directory in which the results of the path-sensitive
+  /// analysis of each translation unit are cached. Top-level functions that
+  /// produced no reports are not analyzed again as long as they, the
+  /// functions they call and the global declarations of the translation unit
+  /// are unchanged. Empty (no caching) is default.
+  ///
+  /// This is controlled by the 'result-cache-dir' config option.
+  StringRef getResultCacheDir();
+
   /// Returns true if lambdas should be inlined. Otherwise a sink node will be
   /// generated each time a LambdaExpr is visited.
   bool shouldInlineLambdas();
@@ -678,6 +747,12 @@ public:
   /// This is controlled by the 'widen-loops' config option.
   bool shouldWidenLoops();
 
+  /// Returns true if paths that reach a CFG join point with states that only
+  /// differ in their constraints should be continued as a single path with
+  /// the constraints joined. This trades precision for fewer paths.
+  /// This is controlled by the 'state-merging' config option.
+  bool shouldMergeStates();
+
   /// Returns true if the analysis should try to unroll loops with known bounds.
   /// This is controlled by the 'unroll-loops' config option.
   bool shouldUnrollLoops();
@@ -715,12 +790,44 @@ public:
   /// translation units.
   bool naiveCTUEnabled();
 
+  /// Returns the memory, in megabytes, that the ASTs loaded for cross
+  /// translation unit analysis may use before the least recently used ones
+  /// are unloaded. The ASTs that the imported declarations still refer to,
+  /// through attributes, stay loaded.
+  ///
+  /// This is controlled by the 'ctu-ast-memory-budget' config option. The
+  /// default value of 0 means no limit.
+  unsigned getCTUASTMemoryBudget();
+
   /// Returns true if elidable C++ copy-constructors and move-constructors
   /// should be actually elided during analysis. Both behaviors are allowed
   /// by the C++ standard, and the analyzer, like CodeGen, defaults to eliding.
   /// Starting with C++17 some elisions become mandatory, and in these cases
   /// the option will be ignored.
   bool shouldElideConstructors();
+
+  /// Returns the number of shards the path-sensitive analysis of the
+  /// translation unit is split into. Each shard is meant to be analyzed by a
+  /// separate analyzer process, so that the shards can be analyzed in
+  /// parallel. 1 (no sharding) is default.
+  ///
+  /// Functions that call each other are always analyzed in the same shard, so
+  /// that inlining works as without sharding. AST-based checks are run in the
+  /// first shard only.
+  ///
+  /// This is controlled by the 'shard-count' config option.
+  unsigned getAnalysisShardCount();
+
+  /// Returns the index of the shard this analyzer process analyzes, from 0 to
+  /// getAnalysisShardCount() - 1. An index outside of that range selects the
+  /// first shard.
+  ///
+  /// This is controlled by the 'shard-index' config option.
+  unsigned getAnalysisShardIndex();
+
+  /// Returns false if the 'shard-index' config option is outside of the range
+  /// of shards, and the first shard is analyzed instead.
+  bool hasValidAnalysisShardIndex();
 };
 
 using AnalyzerOptionsRef = IntrusiveRefCntPtr<AnalyzerOptions>;
@@ -513,6 +513,18 @@ private:
 class GRBugReporter : public BugReporter {
   ExprEngine& Eng;
 
+  /// The graph of the paths leading to the error nodes of all the reports,
+  /// built when the first path diagnostic is generated. The trimmed graph of
+  /// each equivalence class is then built from this graph rather than from
+  /// the whole exploded graph.
+  std::unique_ptr<ExplodedGraph> ReportsGraph;
+  InterExplodedGraphMap ReportsGraphForwardMap;
+  InterExplodedGraphMap ReportsGraphInverseMap;
+  bool ReportsGraphBuilt = false;
+
+  /// Build ReportsGraph if it has not been built yet.
+  void buildReportsGraph();
+
 public:
   GRBugReporter(BugReporterData& d, ExprEngine& eng)
       : BugReporter(d, GRBugReporterKind), Eng(eng) {}
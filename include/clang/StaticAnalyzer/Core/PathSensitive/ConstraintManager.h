@@ -167,6 +167,20 @@ public:
 
   virtual void EndPath(ProgramStateRef state) {}
 
+  /// Returns \p State without any of the constraints tracked by this
+  /// manager, or null if the manager does not support joining states.
+  virtual ProgramStateRef removeAllConstraints(ProgramStateRef State) {
+    return nullptr;
+  }
+
+  /// Returns a state which allows every value allowed by \p StA or by
+  /// \p StB. The two states must only differ in their constraints, that is,
+  /// removeAllConstraints() must return the same state for both.
+  virtual ProgramStateRef joinConstraints(ProgramStateRef StA,
+                                          ProgramStateRef StB) {
+    return nullptr;
+  }
+
   /// Convenience method to query the state to see if a symbol is null or
   /// not null, or if neither assumption can be made.
   ConditionTruthVal isNull(ProgramStateRef State, SymbolRef Sym) {
@@ -68,6 +68,18 @@ public:
   using BlocksAborted =
       std::vector<std::pair<const CFGBlock *, const ExplodedNode *>>;
 
+  /// The reason why ExecuteWorkList() stopped.
+  enum class StopReason {
+    /// There was no work left.
+    WorkListEmpty,
+    /// The maximum number of steps was reached.
+    MaxSteps,
+    /// The time budget was exhausted.
+    TimeBudget,
+    /// The memory budget was exhausted.
+    MemoryBudget
+  };
+
 private:
   SubEngine &SubEng;
 
@@ -96,6 +108,17 @@ private:
   /// (This data is owned by AnalysisConsumer.)
   FunctionSummariesTy *FunctionSummaries;
 
+  /// The wall-clock time ExecuteWorkList() may take, in milliseconds, or 0
+  /// if it is unlimited.
+  unsigned TimeBudget;
+
+  /// The memory the exploded graph and the states in it may take, in bytes,
+  /// or 0 if it is unlimited.
+  uint64_t MemoryBudget;
+
+  /// Why the last call to ExecuteWorkList() stopped.
+  StopReason LastStopReason = StopReason::WorkListEmpty;
+
   void generateNode(const ProgramPoint &Loc,
                     ProgramStateRef State,
                     ExplodedNode *Pred);
@@ -144,6 +167,9 @@ public:
                                        ProgramStateRef InitState,
                                        ExplodedNodeSet &Dst);
 
+  /// Returns why the last call to ExecuteWorkList() stopped.
+  StopReason getStopReason() const { return LastStopReason; }
+
   /// Dispatch the work list item based on the given location information.
   /// Use Pred parameter as the predecessor state.
   void dispatchWorkItem(ExplodedNode* Pred, ProgramPoint Loc,
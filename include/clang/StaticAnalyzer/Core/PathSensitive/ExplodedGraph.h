@@ -34,6 +34,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Compiler.h"
 #include <cassert>
@@ -301,6 +302,17 @@ protected:
   /// Counter to determine when to reclaim nodes.
   unsigned ReclaimCounter;
 
+  /// Tags of program points that only record convenience transitions. Nodes
+  /// with these tags are reclaimed as if they had no tag.
+  llvm::SmallPtrSet<const ProgramPointTag *, 4> ReclaimableTags;
+
+  /// The number of nodes reclaimed so far.
+  unsigned NumReclaimedNodes = 0;
+
+  /// The number of reclaimed nodes that had a tag registered with
+  /// addReclaimableTag(), and would have been kept without it.
+  unsigned NumReclaimedTaggedNodes = 0;
+
 public:
   ExplodedGraph();
   ~ExplodedGraph();
@@ -343,6 +355,16 @@ public:
   bool empty() const { return NumNodes == 0; }
   unsigned size() const { return NumNodes; }
 
+  /// Returns the number of nodes that were removed from the graph by
+  /// reclaimRecentlyAllocatedNodes().
+  unsigned getNumReclaimedNodes() const { return NumReclaimedNodes; }
+
+  /// Returns the number of reclaimed nodes that were only reclaimed because
+  /// their tag was registered with addReclaimableTag().
+  unsigned getNumReclaimedTaggedNodes() const {
+    return NumReclaimedTaggedNodes;
+  }
+
   void reserve(unsigned NodeCount) { Nodes.reserve(NodeCount); }
 
   // Iterators.
@@ -399,12 +421,32 @@ public:
        InterExplodedGraphMap *ForwardMap = nullptr,
        InterExplodedGraphMap *InverseMap = nullptr) const;
 
+  /// Creates a trimmed version of the graph like trim(), but in which the
+  /// predecessors and the successors of each node are in the same order as in
+  /// this graph.
+  ///
+  /// Trimming the returned graph to a subset of \p Nodes then gives the same
+  /// graph as trimming this graph to that subset, so the result can be shared
+  /// by several trims.
+  std::unique_ptr<ExplodedGraph>
+  trimPreservingOrder(ArrayRef<const NodeTy *> Nodes,
+                      InterExplodedGraphMap *ForwardMap = nullptr,
+                      InterExplodedGraphMap *InverseMap = nullptr) const;
+
   /// Enable tracking of recently allocated nodes for potential reclamation
   /// when calling reclaimRecentlyAllocatedNodes().
   void enableNodeReclamation(unsigned Interval) {
     ReclaimCounter = ReclaimNodeInterval = Interval;
   }
 
+  /// Allow reclaiming nodes whose program point carries \p Tag.
+  ///
+  /// This is meant for tags of transitions that are not consulted when
+  /// reconstructing bug paths, such as the ones of dead symbol cleanup.
+  void addReclaimableTag(const ProgramPointTag *Tag) {
+    ReclaimableTags.insert(Tag);
+  }
+
   /// Reclaim "uninteresting" nodes created since the last time this method
   /// was called.
   void reclaimRecentlyAllocatedNodes();
@@ -414,6 +456,10 @@ public:
   static bool isInterestingLValueExpr(const Expr *Ex);
 
 private:
+  bool isReclaimableTag(const ProgramPointTag *Tag) const {
+    return !Tag || ReclaimableTags.count(Tag);
+  }
+
   bool shouldCollect(const ExplodedNode *node);
   void collectNode(ExplodedNode *node);
 };
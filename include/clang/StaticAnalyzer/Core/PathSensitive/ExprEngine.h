@@ -34,6 +34,7 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/SubEngine.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/WorkList.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include <cassert>
 #include <utility>
 
@@ -156,6 +157,17 @@ private:
   /// The flag, which specifies the mode of inlining for the engine.
   InliningModes HowToInline;
 
+  /// The block, its location context and a state without constraints.
+  using JoinPointKey =
+      std::pair<std::pair<const CFGBlock *, const LocationContext *>,
+                const ProgramState *>;
+
+  /// When states are merged, the state without constraints and the joined
+  /// state of the paths that entered a block with that state apart from the
+  /// constraints.
+  llvm::DenseMap<JoinPointKey, std::pair<ProgramStateRef, ProgramStateRef>>
+      JoinedStates;
+
 public:
   ExprEngine(cross_tu::CrossTranslationUnitContext &CTU, AnalysisManager &mgr,
              bool gcEnabled, SetOfConstDecls *VisitedCalleesIn,
@@ -284,6 +296,12 @@ public:
                                NodeBuilderWithSinks &nodeBuilder,
                                ExplodedNode *Pred) override;
 
+  /// Join the state of \p Pred with the states of the other paths that
+  /// entered the same join point with the same state apart from the
+  /// constraints, if the 'state-merging' option is enabled.
+  void joinStatesAtBlockEntrance(NodeBuilderWithSinks &nodeBuilder,
+                                 ExplodedNode *Pred);
+
   /// ProcessBranch - Called by CoreEngine.  Used to generate successor
   ///  nodes by processing the 'effects' of a branch condition.
   void processBranch(const Stmt *Condition, const Stmt *Term,
@@ -17,6 +17,9 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramState.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramStateTrait.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/SimpleConstraintManager.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Allocator.h"
 
 namespace clang {
 
@@ -46,81 +49,107 @@ public:
   }
 };
 
-class RangeTrait : public llvm::ImutContainerInfo<Range> {
-public:
-  // When comparing if one Range is less than another, we should compare
-  // the actual APSInt values instead of their pointers.  This keeps the order
-  // consistent (instead of comparing by pointer values) and can potentially
-  // be used to speed up some of the operations in RangeSet.
-  static inline bool isLess(key_type_ref lhs, key_type_ref rhs) {
-    return *lhs.first < *rhs.first ||
-           (!(*rhs.first < *lhs.first) && *lhs.second < *rhs.second);
-  }
-};
-
 /// RangeSet contains a set of ranges. If the set is empty, then
 ///  there the value of a symbol is overly constrained and there are no
 ///  possible values for that symbol.
+///
+/// The ranges are kept sorted in a small vector, which is uniqued by the
+/// Factory that created the set. Sets are immutable, so two sets are equal
+/// if and only if they share their storage.
 class RangeSet {
-  typedef llvm::ImmutableSet<Range, RangeTrait> PrimRangeSet;
-  PrimRangeSet ranges; // no need to make const, since it is an
-                       // ImmutableSet - this allows default operator=
-                       // to work.
 public:
-  typedef PrimRangeSet::Factory Factory;
-  typedef PrimRangeSet::iterator iterator;
-
-  RangeSet(PrimRangeSet RS) : ranges(RS) {}
+  using ContainerType = llvm::SmallVector<Range, 4>;
+  using iterator = ContainerType::const_iterator;
+
+  /// Creates and uniques the storage of RangeSets. The storage lives as long
+  /// as the factory.
+  class Factory {
+  public:
+    /// Returns the set containing no ranges.
+    RangeSet getEmptySet() { return getRangeSet(ContainerType()); }
+
+    /// Returns the set '{ [From, To] }'.
+    RangeSet getRangeSet(const llvm::APSInt &From, const llvm::APSInt &To) {
+      ContainerType Ranges;
+      Ranges.push_back(Range(From, To));
+      return getRangeSet(std::move(Ranges));
+    }
+
+    /// Returns the set of the given ranges, which must not overlap.
+    RangeSet getRangeSet(ContainerType Ranges);
+
+  private:
+    struct Storage : public llvm::FoldingSetNode {
+      ContainerType Ranges;
+
+      Storage(ContainerType Ranges) : Ranges(std::move(Ranges)) {}
+
+      void Profile(llvm::FoldingSetNodeID &ID) const {
+        Profile(ID, Ranges);
+      }
+
+      static void Profile(llvm::FoldingSetNodeID &ID,
+                          const ContainerType &Ranges) {
+        for (const Range &R : Ranges)
+          R.Profile(ID);
+      }
+    };
+
+    llvm::FoldingSet<Storage> Cache;
+    llvm::SpecificBumpPtrAllocator<Storage> Arena;
+  };
 
   /// Create a new set with all ranges of this set and RS.
   /// Possible intersections are not checked here.
-  RangeSet addRange(Factory &F, const RangeSet &RS) {
-    PrimRangeSet Ranges(RS.ranges);
-    for (const auto &range : ranges)
-      Ranges = F.add(Ranges, range);
-    return RangeSet(Ranges);
-  }
+  RangeSet addRange(Factory &F, const RangeSet &RS) const;
 
-  iterator begin() const { return ranges.begin(); }
-  iterator end() const { return ranges.end(); }
+  iterator begin() const { return Ranges->begin(); }
+  iterator end() const { return Ranges->end(); }
 
-  bool isEmpty() const { return ranges.isEmpty(); }
+  bool isEmpty() const { return Ranges->empty(); }
 
   /// Construct a new RangeSet representing '{ [from, to] }'.
   RangeSet(Factory &F, const llvm::APSInt &from, const llvm::APSInt &to)
-      : ranges(F.add(F.getEmptySet(), Range(from, to))) {}
+      : RangeSet(F.getRangeSet(from, to)) {}
 
   /// Profile - Generates a hash profile of this RangeSet for use
   ///  by FoldingSet.
-  void Profile(llvm::FoldingSetNodeID &ID) const { ranges.Profile(ID); }
+  void Profile(llvm::FoldingSetNodeID &ID) const { ID.AddPointer(Ranges); }
 
   /// getConcreteValue - If a symbol is contrained to equal a specific integer
   ///  constant then this method returns that value.  Otherwise, it returns
   ///  NULL.
   const llvm::APSInt *getConcreteValue() const {
-    return ranges.isSingleton() ? ranges.begin()->getConcreteValue() : nullptr;
+    return Ranges->size() == 1 ? Ranges->front().getConcreteValue() : nullptr;
   }
 
 private:
-  void IntersectInRange(BasicValueFactory &BV, Factory &F,
-                        const llvm::APSInt &Lower, const llvm::APSInt &Upper,
-                        PrimRangeSet &newRanges, PrimRangeSet::iterator &i,
-                        PrimRangeSet::iterator &e) const;
+  explicit RangeSet(const ContainerType *Ranges) : Ranges(Ranges) {}
+
+  void IntersectInRange(BasicValueFactory &BV, const llvm::APSInt &Lower,
+                        const llvm::APSInt &Upper, ContainerType &NewRanges,
+                        iterator &i, iterator e) const;
 
   const llvm::APSInt &getMinValue() const;
 
   bool pin(llvm::APSInt &Lower, llvm::APSInt &Upper) const;
 
+  /// The uniqued, sorted ranges of the set.
+  const ContainerType *Ranges;
+
 public:
   RangeSet Intersect(BasicValueFactory &BV, Factory &F, llvm::APSInt Lower,
                      llvm::APSInt Upper) const;
 
   RangeSet Negate(BasicValueFactory &BV, Factory &F) const;
 
+  /// Returns a set containing the values in this set and in \p Other.
+  RangeSet Union(Factory &F, const RangeSet &Other) const;
+
   void print(raw_ostream &os) const;
 
   bool operator==(const RangeSet &other) const {
-    return ranges == other.ranges;
+    return Ranges == other.Ranges;
   }
 };
 
@@ -66,9 +66,19 @@ protected:
   /// the solver
   virtual void addStateConstraints(ProgramStateRef State) const = 0;
 
+  /// Make the outermost scope of the solver hold the constraints of the given
+  /// state. Queries about the state are then made in a nested scope, so that
+  /// the solver can keep its work on the state constraints between queries.
+  /// By default the solver is reset and the constraints are added again.
+  virtual void setStateConstraints(ProgramStateRef State) const;
+
   // Generate and check a Z3 model, using the given constraint.
   ConditionTruthVal checkModel(ProgramStateRef State,
                                const SMTExprRef &Exp) const;
+
+  /// Check the satisfiability of the constraints in the solver, recording the
+  /// number and the duration of the solver calls.
+  ConditionTruthVal checkSolver() const;
 }; // end class SMTConstraintManager
 
 } // namespace ento
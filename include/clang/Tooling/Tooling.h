@@ -33,6 +33,7 @@
 #include "clang/AST/ASTConsumer.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/LLVM.h"
+#include "clang/Basic/SharedModuleCache.h"
 #include "clang/Basic/VirtualFileSystem.h"
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Frontend/PCHContainerOperations.h"
@@ -273,6 +274,11 @@ public:
   // FIXME: remove this when all users have migrated!
   void mapVirtualFile(StringRef FilePath, StringRef Content);
 
+  /// Share the module files the invocation reads with other compilations.
+  void setSharedModuleCache(IntrusiveRefCntPtr<SharedModuleCache> Cache) {
+    SharedModuleFiles = std::move(Cache);
+  }
+
   /// Run the clang invocation.
   ///
   /// \returns True if there were no errors during execution.
@@ -294,6 +300,7 @@ public:
   // Maps <file name> -> <file content>.
   llvm::StringMap<StringRef> MappedFileContents;
   DiagnosticConsumer *DiagConsumer = nullptr;
+  IntrusiveRefCntPtr<SharedModuleCache> SharedModuleFiles;
 };
 
 /// Utility to run a FrontendAction over a set of files.
@@ -344,6 +351,12 @@ public:
   /// Clear the command line arguments adjuster chain.
   void clearArgumentsAdjusters();
 
+  /// Share the module files read for one translation unit with the others,
+  /// instead of reading them again for each of them.
+  void setSharedModuleCache(IntrusiveRefCntPtr<SharedModuleCache> Cache) {
+    SharedModuleFiles = std::move(Cache);
+  }
+
   /// Runs an action over all files specified in the command line.
   ///
   /// \param Action Tool action.
@@ -380,6 +393,8 @@ private:
   ArgumentsAdjuster ArgsAdjuster;
 
   DiagnosticConsumer *DiagConsumer = nullptr;
+
+  IntrusiveRefCntPtr<SharedModuleCache> SharedModuleFiles;
 };
 
 template <typename T>
@@ -128,6 +128,23 @@ class ItaniumMangleContextImpl : public ItaniumMangleContext {
   llvm::DenseMap<DiscriminatorKeyTy, unsigned> Discriminator;
   llvm::DenseMap<const NamedDecl*, unsigned> Uniquifier;
 
+public:
+  /// The mangling of a prefix that starts a name, along with the
+  /// substitutions it introduces.
+  struct PrefixMangling {
+    /// False if the prefix can't be reused, e.g. because it has ABI tags.
+    bool Reusable = false;
+    std::string Mangling;
+    SmallVector<std::pair<uintptr_t, unsigned>, 4> Substitutions;
+    unsigned SeqID = 0;
+  };
+
+private:
+  /// Prefixes mangled with an empty substitution table, by their canonical
+  /// declaration. Most symbols of a class or namespace start with the same
+  /// prefix, so this saves mangling it again for each of them.
+  llvm::DenseMap<const NamedDecl *, PrefixMangling> PrefixManglings;
+
 public:
   explicit ItaniumMangleContextImpl(ASTContext &Context,
                                     DiagnosticsEngine &Diags)
@@ -208,6 +225,14 @@ public:
     return true;
   }
   /// @}
+
+  const PrefixMangling *getPrefixMangling(const NamedDecl *ND) const {
+    auto I = PrefixManglings.find(ND);
+    return I == PrefixManglings.end() ? nullptr : &I->second;
+  }
+  void setPrefixMangling(const NamedDecl *ND, PrefixMangling Mangling) {
+    PrefixManglings[ND] = std::move(Mangling);
+  }
 };
 
 /// Manage the mangling of a single name.
@@ -512,6 +537,8 @@ private:
                         unsigned NumTemplateArgs);
   void manglePrefix(NestedNameSpecifier *qualifier);
   void manglePrefix(const DeclContext *DC, bool NoFunction=false);
+  void mangleUncachedPrefix(const NamedDecl *ND, bool NoFunction);
+  bool mangleCachedPrefix(const NamedDecl *ND, bool NoFunction);
   void manglePrefix(QualType type);
   void mangleTemplatePrefix(const TemplateDecl *ND, bool NoFunction=false);
   void mangleTemplatePrefix(TemplateName Template);
@@ -1797,6 +1824,14 @@ void CXXNameMangler::manglePrefix(const DeclContext *DC, bool NoFunction) {
   if (mangleSubstitution(ND))
     return;
 
+  if (mangleCachedPrefix(ND, NoFunction))
+    return;
+
+  mangleUncachedPrefix(ND, NoFunction);
+}
+
+void CXXNameMangler::mangleUncachedPrefix(const NamedDecl *ND,
+                                          bool NoFunction) {
   // Check if we have a template.
   const TemplateArgumentList *TemplateArgs = nullptr;
   if (const TemplateDecl *TD = isTemplate(ND, TemplateArgs)) {
@@ -1810,6 +1845,73 @@ void CXXNameMangler::manglePrefix(const DeclContext *DC, bool NoFunction) {
   addSubstitution(ND);
 }
 
+/// Whether the mangling of a prefix only depends on the declarations that
+/// make it up, and not on the entity whose name it starts.
+static bool isReusablePrefix(const DeclContext *DC) {
+  for (; !DC->isTranslationUnit(); DC = getEffectiveParentContext(DC)) {
+    if (isa<NamespaceDecl>(DC) || isa<LinkageSpecDecl>(DC))
+      continue;
+    const auto *RD = dyn_cast<CXXRecordDecl>(DC);
+    if (!RD || RD->isLambda())
+      return false;
+  }
+  return true;
+}
+
+/// Mangle a prefix that starts a name from the cache of the mangle context,
+/// adding it to the cache first if needed. Returns false if the prefix must
+/// be mangled in place.
+bool CXXNameMangler::mangleCachedPrefix(const NamedDecl *ND, bool NoFunction) {
+  // The cached manglings start from an empty substitution table, and the
+  // manglers that only gather ABI tags don't need them.
+  if (NullOut || DisableDerivedAbiTags || SeqID != 0 ||
+      !ModuleSubstitutions.empty() || FunctionTypeDepth.getDepth() != 0)
+    return false;
+
+  ND = cast<NamedDecl>(ND->getCanonicalDecl());
+  using PrefixMangling = ItaniumMangleContextImpl::PrefixMangling;
+  if (const PrefixMangling *Cached = Context.getPrefixMangling(ND)) {
+    if (!Cached->Reusable)
+      return false;
+    Out << Cached->Mangling;
+    Substitutions.insert(Cached->Substitutions.begin(),
+                         Cached->Substitutions.end());
+    SeqID = Cached->SeqID;
+    return true;
+  }
+
+  if (!isReusablePrefix(cast<DeclContext>(ND))) {
+    Context.setPrefixMangling(ND, PrefixMangling());
+    return false;
+  }
+
+  SmallString<64> Buffer;
+  llvm::raw_svector_ostream BufferOut(Buffer);
+  CXXNameMangler Mangler(*this, BufferOut);
+  Mangler.mangleUncachedPrefix(ND, NoFunction);
+
+  // ABI tags and module names are tracked across the whole name, so they
+  // can't be replayed from the cache.
+  PrefixMangling Result;
+  Result.Reusable = Mangler.AbiTagsRoot.getUsedAbiTags().empty() &&
+                    Mangler.AbiTagsRoot.getEmittedAbiTags().empty() &&
+                    Mangler.ModuleSubstitutions.empty();
+  if (!Result.Reusable) {
+    Context.setPrefixMangling(ND, std::move(Result));
+    return false;
+  }
+
+  Result.Mangling = Buffer.str();
+  Result.Substitutions.append(Mangler.Substitutions.begin(),
+                              Mangler.Substitutions.end());
+  Result.SeqID = Mangler.SeqID;
+  Context.setPrefixMangling(ND, std::move(Result));
+
+  Out << Buffer;
+  extendSubstitutions(&Mangler);
+  return true;
+}
+
 void CXXNameMangler::mangleTemplatePrefix(TemplateName Template) {
   // <template-prefix> ::= <prefix> <template unqualified-name>
   //                   ::= <template-param>
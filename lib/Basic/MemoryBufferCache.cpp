@@ -21,6 +21,15 @@ MemoryBufferCache::addBuffer(llvm::StringRef Filename,
   return *Insertion.first->second.Buffer;
 }
 
+llvm::MemoryBuffer &
+MemoryBufferCache::addBuffer(llvm::StringRef Filename,
+                             std::shared_ptr<llvm::MemoryBuffer> Buffer) {
+  auto Insertion =
+      Buffers.insert({Filename, BufferEntry{std::move(Buffer), NextIndex++}});
+  assert(Insertion.second && "Already has a buffer");
+  return *Insertion.first->second.Buffer;
+}
+
 llvm::MemoryBuffer *MemoryBufferCache::lookupBuffer(llvm::StringRef Filename) {
   auto I = Buffers.find(Filename);
   if (I == Buffers.end())
@@ -41,6 +50,8 @@ bool MemoryBufferCache::tryToRemoveBuffer(llvm::StringRef Filename) {
   if (I->second.Index < FirstRemovableIndex)
     return true;
 
+  if (SharedCache)
+    SharedCache->removeBuffer(Filename, I->second.Buffer.get());
   Buffers.erase(I);
   return false;
 }
@@ -0,0 +1,116 @@
+//===- SharedModuleCache.cpp - Process-wide cache of module files ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/SharedModuleCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+std::shared_ptr<llvm::MemoryBuffer>
+SharedModuleCache::lookupBuffer(StringRef Filename, off_t Size, time_t ModTime,
+                                time_t *ValidationTime) {
+  if (ValidationTime)
+    *ValidationTime = 0;
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto I = Entries.find(Filename);
+  if (I == Entries.end() || I->second.Size != Size ||
+      I->second.ModTime != ModTime) {
+    ++NumMisses;
+    return nullptr;
+  }
+
+  ++NumHits;
+  I->second.LastUse = ++CurrentTick;
+  if (ValidationTime)
+    *ValidationTime = I->second.ValidationTime;
+  return I->second.Buffer;
+}
+
+void SharedModuleCache::addBuffer(StringRef Filename, off_t Size,
+                                  time_t ModTime,
+                                  std::shared_ptr<llvm::MemoryBuffer> Buffer) {
+  assert(Buffer && "Adding a null buffer");
+  std::lock_guard<std::mutex> Lock(Mutex);
+  CacheEntry &Entry = Entries[Filename];
+  if (Entry.Buffer)
+    TotalSize -= Entry.Buffer->getBufferSize();
+  TotalSize += Buffer->getBufferSize();
+  Entry.Buffer = std::move(Buffer);
+  Entry.Size = Size;
+  Entry.ModTime = ModTime;
+  Entry.ValidationTime = 0;
+  Entry.LastUse = ++CurrentTick;
+  evictToBudget();
+}
+
+void SharedModuleCache::removeBuffer(StringRef Filename,
+                                     const llvm::MemoryBuffer *Buffer) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto I = Entries.find(Filename);
+  if (I == Entries.end() || I->second.Buffer.get() != Buffer)
+    return;
+  TotalSize -= I->second.Buffer->getBufferSize();
+  Entries.erase(I);
+}
+
+void SharedModuleCache::markValidated(StringRef Filename, time_t When) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto I = Entries.find(Filename);
+  if (I != Entries.end() && I->second.ValidationTime < When)
+    I->second.ValidationTime = When;
+}
+
+void SharedModuleCache::setMemoryBudget(size_t Budget) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  MemoryBudget = Budget;
+  evictToBudget();
+}
+
+size_t SharedModuleCache::getMemoryBudget() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return MemoryBudget;
+}
+
+size_t SharedModuleCache::getTotalSize() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return TotalSize;
+}
+
+unsigned SharedModuleCache::getNumHits() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return NumHits;
+}
+
+void SharedModuleCache::evictToBudget() {
+  if (!MemoryBudget)
+    return;
+
+  // Entries are few (one per module file), so a linear scan for the oldest
+  // one is cheap compared to reading a module file.
+  while (TotalSize > MemoryBudget && !Entries.empty()) {
+    auto Oldest = Entries.begin();
+    for (auto I = Entries.begin(), E = Entries.end(); I != E; ++I)
+      if (I->second.LastUse < Oldest->second.LastUse)
+        Oldest = I;
+    TotalSize -= Oldest->second.Buffer->getBufferSize();
+    Entries.erase(Oldest);
+    ++NumEvictions;
+  }
+}
+
+void SharedModuleCache::printStats() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  llvm::errs() << "*** Shared Module Cache Stats:\n"
+               << "  " << Entries.size() << " module files cached ("
+               << TotalSize << " bytes)\n"
+               << "  " << NumHits << " hits, " << NumMisses << " misses, "
+               << NumEvictions << " evictions\n";
+}
@@ -11,10 +11,12 @@
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/LangOptions.h"
 #include "clang/Basic/TargetOptions.h"
+#include "clang/Config/config.h"
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Frontend/Utils.h"
 #include "clang/Lex/HeaderSearchOptions.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSwitch.h"
@@ -28,7 +30,11 @@
 #include "llvm/CodeGen/SchedulerRegistry.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/IR/IRPrintingPasses.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
@@ -38,9 +44,16 @@
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
@@ -58,9 +71,16 @@
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Scalar/GVN.h"
 #include "llvm/Transforms/Utils.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/NameAnonGlobals.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "llvm/Transforms/Utils/SymbolRewriter.h"
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#ifdef CLANG_HAVE_MALLINFO2
+#include <malloc.h>
+#endif
 using namespace clang;
 using namespace llvm;
 
@@ -69,6 +89,107 @@ namespace {
 // Default filename used for profile generation.
 static constexpr StringLiteral DefaultProfileGenName = "default_%m.profraw";
 
+/// Returns the number of bytes allocated on the heap. The mallinfo() behind
+/// sys::Process::GetMallocUsage() on glibc reports it in an int, which wraps
+/// for heaps over 2 GB, so use mallinfo2() where it is available.
+static size_t getHeapInUse() {
+#ifdef CLANG_HAVE_MALLINFO2
+  return ::mallinfo2().uordblks;
+#else
+  return sys::Process::GetMallocUsage();
+#endif
+}
+
+/// Tracks the heap in use during the phases of the backend, for -ftime-report.
+class BackendMemoryReport {
+  struct Phase {
+    const char *Name;
+    size_t Peak;
+    size_t AtEnd;
+  };
+
+  bool Enabled;
+  size_t Peak = 0;
+  SmallVector<Phase, 4> Phases;
+
+public:
+  explicit BackendMemoryReport(bool Enabled) : Enabled(Enabled) {
+    // Everything allocated so far belongs to parsing and IR generation.
+    endPhase("IR generation");
+  }
+
+  bool isEnabled() const { return Enabled; }
+
+  /// Record the heap in use in the middle of the current phase.
+  void sample() {
+    if (Enabled)
+      Peak = std::max(Peak, getHeapInUse());
+  }
+
+  /// Record the end of the current phase.
+  void endPhase(const char *Name) {
+    if (!Enabled)
+      return;
+    size_t InUse = getHeapInUse();
+    Phases.push_back({Name, std::max(Peak, InUse), InUse});
+    Peak = InUse;
+  }
+
+  void print(raw_ostream &OS) const {
+    if (!Enabled)
+      return;
+    OS << "===" << std::string(73, '-') << "===\n"
+       << "                          Backend Memory Usage\n"
+       << "===" << std::string(73, '-') << "===\n"
+       << "  Peak (KB)   At End (KB)   Phase\n";
+    for (const Phase &P : Phases)
+      OS << format("  %9zu   %11zu   %s\n", P.Peak >> 10, P.AtEnd >> 10,
+                   P.Name);
+    OS << "\n";
+  }
+};
+
+/// Runs once the code generator has written out a function. Samples the heap
+/// for the memory report and, with -ffree-ir-after-codegen, frees the IR of
+/// the function body so that the module shrinks while code is generated.
+class ReleaseEmittedFunction : public FunctionPass {
+  BackendMemoryReport &MemReport;
+  bool FreeBody;
+
+public:
+  static char ID;
+
+  ReleaseEmittedFunction(BackendMemoryReport &MemReport, bool FreeBody)
+      : FunctionPass(ID), MemReport(MemReport), FreeBody(FreeBody) {}
+
+  StringRef getPassName() const override {
+    return "Release emitted function IR";
+  }
+
+  bool runOnFunction(Function &F) override {
+    MemReport.sample();
+    if (!FreeBody)
+      return false;
+
+    // Other code may still refer to a block whose address is taken.
+    for (const BasicBlock &BB : F)
+      if (BB.hasAddressTaken())
+        return false;
+
+    // Leave a single unreachable block behind, so that the function is still
+    // a definition and the code generated for its callers does not change.
+    for (BasicBlock &BB : F)
+      BB.dropAllReferences();
+    while (!F.empty())
+      F.begin()->eraseFromParent();
+    new UnreachableInst(F.getContext(),
+                        BasicBlock::Create(F.getContext(), "", &F));
+    return true;
+  }
+};
+
+char ReleaseEmittedFunction::ID = 0;
+
 class EmitAssemblyHelper {
   DiagnosticsEngine &Diags;
   const HeaderSearchOptions &HSOpts;
@@ -106,6 +227,19 @@ class EmitAssemblyHelper {
   bool AddEmitPasses(legacy::PassManager &CodeGenPasses, BackendAction Action,
                      raw_pwrite_stream &OS, raw_pwrite_stream *DwoOS);
 
+  /// Whether the object file is emitted by EmitObjectInParallel.
+  bool shouldEmitObjectInParallel(BackendAction Action) const {
+    return Action == Backend_EmitObj && CodeGenOpts.ParallelCodeGenJobs > 1 &&
+           !CodeGenOpts.ParallelCodeGenLinker.empty() &&
+           CodeGenOpts.SplitDwarfFile.empty();
+  }
+
+  /// Split the module, generate code for the parts on separate threads, and
+  /// combine the resulting objects into one with a partial link.
+  ///
+  /// \return True on success.
+  bool EmitObjectInParallel(raw_pwrite_stream &OS);
+
   std::unique_ptr<llvm::ToolOutputFile> openOutputFile(StringRef Path) {
     std::error_code EC;
     auto F = llvm::make_unique<llvm::ToolOutputFile>(Path, EC,
@@ -745,6 +879,258 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   return true;
 }
 
+namespace {
+/// Forwards the backend diagnostics of the parts of a split module to the
+/// handlers of the original module's context, so that they are reported like
+/// those of serial code generation: remarks are filtered by -Rpass and
+/// warnings keep their groups and source locations. The default handler of
+/// LLVMContext would instead exit on the first error, while the other parts
+/// are still being compiled.
+///
+/// The main thread only waits while the parts are compiled, so the handlers
+/// are called from the worker threads, one at a time. To keep the output
+/// deterministic, a part only reports once all parts before it are done.
+class PartDiagnosticForwarder {
+  LLVMContext &MainContext;
+  std::mutex Mutex;
+  std::condition_variable PartDone;
+  std::vector<bool> Done;
+  /// The part whose diagnostics are forwarded next.
+  unsigned Turn = 0;
+  bool HadErrors = false;
+
+public:
+  PartDiagnosticForwarder(LLVMContext &MainContext, unsigned NumParts)
+      : MainContext(MainContext), Done(NumParts) {}
+
+  LLVMContext &getMainContext() const { return MainContext; }
+
+  /// Calls \p Report once the diagnostics of \p Part can be forwarded.
+  void forward(unsigned Part, bool IsError, llvm::function_ref<void()> Report) {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    PartDone.wait(Lock, [&] { return Turn == Part; });
+    HadErrors |= IsError;
+    Report();
+  }
+
+  /// Records that \p Part has no more diagnostics to forward.
+  void finish(unsigned Part) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Done[Part] = true;
+    while (Turn != Done.size() && Done[Turn])
+      ++Turn;
+    PartDone.notify_all();
+  }
+
+  /// Whether any part reported an error. Only valid once all parts are done.
+  bool hadErrors() const { return HadErrors; }
+};
+
+/// The diagnostic handler of the context in which a part is compiled.
+class PartDiagnosticHandler : public DiagnosticHandler {
+  PartDiagnosticForwarder &Forwarder;
+  unsigned Part;
+  const DiagnosticHandler &MainHandler;
+
+public:
+  PartDiagnosticHandler(PartDiagnosticForwarder &Forwarder, unsigned Part)
+      : Forwarder(Forwarder), Part(Part),
+        MainHandler(*Forwarder.getMainContext().getDiagHandlerPtr()) {}
+
+  bool handleDiagnostics(const DiagnosticInfo &DI) override {
+    Forwarder.forward(Part, DI.getSeverity() == DS_Error,
+                      [&] { Forwarder.getMainContext().diagnose(DI); });
+    return true;
+  }
+
+  bool isAnalysisRemarkEnabled(StringRef PassName) const override {
+    return MainHandler.isAnalysisRemarkEnabled(PassName);
+  }
+  bool isMissedOptRemarkEnabled(StringRef PassName) const override {
+    return MainHandler.isMissedOptRemarkEnabled(PassName);
+  }
+  bool isPassedOptRemarkEnabled(StringRef PassName) const override {
+    return MainHandler.isPassedOptRemarkEnabled(PassName);
+  }
+  bool isAnyRemarkEnabled() const override {
+    return MainHandler.isAnyRemarkEnabled();
+  }
+};
+
+/// The context of the inline assembly diagnostic handler of a part.
+struct PartInlineAsmContext {
+  PartDiagnosticForwarder &Forwarder;
+  unsigned Part;
+};
+} // end anonymous namespace
+
+static void handlePartInlineAsmDiagnostic(const SMDiagnostic &D,
+                                          void *Context, unsigned LocCookie) {
+  auto *Part = static_cast<PartInlineAsmContext *>(Context);
+  LLVMContext &MainContext = Part->Forwarder.getMainContext();
+  bool IsError = D.getKind() == SourceMgr::DK_Error;
+  Part->Forwarder.forward(Part->Part, IsError, [&] {
+    if (LLVMContext::InlineAsmDiagHandlerTy Handler =
+            MainContext.getInlineAsmDiagnosticHandler()) {
+      Handler(D, MainContext.getInlineAsmDiagnosticContext(), LocCookie);
+      return;
+    }
+    DiagnosticSeverity Severity =
+        IsError ? DS_Error
+                : D.getKind() == SourceMgr::DK_Warning ? DS_Warning : DS_Note;
+    MainContext.diagnose(
+        DiagnosticInfoInlineAsm(LocCookie, D.getMessage(), Severity));
+  });
+}
+
+/// Generate an object file for one part of a split module, in a context of its
+/// own so that the parts can be compiled concurrently. Backend diagnostics
+/// are passed to \p Forwarder; other failures are returned.
+static std::string emitObjectForPart(StringRef Bitcode,
+                                     const TargetMachine &BaseTM,
+                                     const CodeGenOptions &CodeGenOpts,
+                                     raw_pwrite_stream &OS,
+                                     PartDiagnosticForwarder &Forwarder,
+                                     unsigned PartIndex) {
+  LLVMContext Context;
+  Context.setDiagnosticHandler(
+      llvm::make_unique<PartDiagnosticHandler>(Forwarder, PartIndex));
+  PartInlineAsmContext InlineAsmContext{Forwarder, PartIndex};
+  Context.setInlineAsmDiagnosticHandler(handlePartInlineAsmDiagnostic,
+                                        &InlineAsmContext);
+  Context.setDiagnosticsHotnessRequested(
+      Forwarder.getMainContext().getDiagnosticsHotnessRequested());
+  Expected<std::unique_ptr<Module>> PartOrErr =
+      parseBitcodeFile(MemoryBufferRef(Bitcode, "<split module>"), Context);
+  if (!PartOrErr)
+    return toString(PartOrErr.takeError());
+  Module &Part = **PartOrErr;
+
+  std::unique_ptr<TargetMachine> TM(BaseTM.getTarget().createTargetMachine(
+      BaseTM.getTargetTriple().str(), BaseTM.getTargetCPU(),
+      BaseTM.getTargetFeatureString(), BaseTM.Options,
+      BaseTM.getRelocationModel(), BaseTM.getCodeModel(),
+      BaseTM.getOptLevel()));
+
+  legacy::PassManager CodeGenPasses;
+  CodeGenPasses.add(
+      createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
+  llvm::Triple TargetTriple(Part.getTargetTriple());
+  std::unique_ptr<TargetLibraryInfoImpl> TLII(
+      createTLII(TargetTriple, CodeGenOpts));
+  CodeGenPasses.add(new TargetLibraryInfoWrapperPass(*TLII));
+  if (CodeGenOpts.OptimizationLevel > 0)
+    CodeGenPasses.add(createObjCARCContractPass());
+
+  if (TM->addPassesToEmitFile(CodeGenPasses, OS, nullptr,
+                              TargetMachine::CGFT_ObjectFile,
+                              /*DisableVerify=*/!CodeGenOpts.VerifyModule))
+    return "the target does not support object file emission";
+
+  CodeGenPasses.run(Part);
+  return std::string();
+}
+
+bool EmitAssemblyHelper::EmitObjectInParallel(raw_pwrite_stream &OS) {
+  unsigned DiagID = Diags.getCustomDiagID(
+      DiagnosticsEngine::Error, "parallel code generation failed: %0");
+
+  // Write each part as bitcode, so that it can be read into the context of
+  // the thread compiling it. Locals stay in the part of their users, so that
+  // no symbol becomes visible outside of the object file.
+  SmallVector<SmallString<0>, 8> Parts;
+  SplitModule(CloneModule(*TheModule), CodeGenOpts.ParallelCodeGenJobs,
+              [&](std::unique_ptr<Module> Part) {
+                Parts.emplace_back();
+                raw_svector_ostream BitcodeOS(Parts.back());
+                WriteBitcodeToFile(*Part, BitcodeOS);
+              },
+              /*PreserveLocals=*/true);
+
+  SmallVector<SmallString<128>, 8> PartFiles(Parts.size());
+  auto RemovePartFiles = llvm::make_scope_exit([&] {
+    for (const SmallString<128> &PartFile : PartFiles)
+      if (!PartFile.empty())
+        sys::fs::remove(PartFile);
+  });
+
+  // Create the files up front, so that no part waits for the diagnostics of
+  // a part that was never started.
+  SmallVector<int, 8> PartFDs(Parts.size());
+  for (unsigned I = 0, E = Parts.size(); I != E; ++I) {
+    if (std::error_code EC = sys::fs::createTemporaryFile(
+            "clang-codegen", "o", PartFDs[I], PartFiles[I])) {
+      for (unsigned J = 0; J != I; ++J)
+        sys::Process::SafelyCloseFileDescriptor(PartFDs[J]);
+      Diags.Report(DiagID) << EC.message();
+      return false;
+    }
+  }
+
+  PartDiagnosticForwarder Forwarder(TheModule->getContext(), Parts.size());
+  std::vector<std::string> PartFailures(Parts.size());
+  {
+    ThreadPool Pool(CodeGenOpts.ParallelCodeGenJobs);
+    for (unsigned I = 0, E = Parts.size(); I != E; ++I) {
+      Pool.async([&, I] {
+        {
+          raw_fd_ostream PartOS(PartFDs[I], /*shouldClose=*/true);
+          PartFailures[I] = emitObjectForPart(Parts[I], *TM, CodeGenOpts,
+                                              PartOS, Forwarder, I);
+        }
+        Forwarder.finish(I);
+      });
+    }
+  }
+
+  // Report the failures in part order, so that they are deterministic.
+  bool HasErrors = Forwarder.hadErrors();
+  for (const std::string &Failure : PartFailures) {
+    if (Failure.empty())
+      continue;
+    Diags.Report(DiagID) << Failure;
+    HasErrors = true;
+  }
+  if (HasErrors)
+    return false;
+
+  // Combine the parts in a fixed order, so that the output is deterministic.
+  SmallString<128> LinkedFile;
+  if (std::error_code EC =
+          sys::fs::createTemporaryFile("clang-codegen", "o", LinkedFile)) {
+    Diags.Report(DiagID) << EC.message();
+    return false;
+  }
+  FileRemover RemoveLinkedFile(LinkedFile);
+
+  std::string Triple = TheModule->getTargetTriple();
+  std::vector<StringRef> LinkArgs = {CodeGenOpts.ParallelCodeGenLinker,
+                                     "-r",
+                                     "-nostdlib",
+                                     "-target",
+                                     Triple,
+                                     "-o",
+                                     LinkedFile};
+  LinkArgs.insert(LinkArgs.end(), PartFiles.begin(), PartFiles.end());
+
+  std::string ErrMsg;
+  if (sys::ExecuteAndWait(CodeGenOpts.ParallelCodeGenLinker, LinkArgs,
+                          /*Env=*/None, /*Redirects=*/{}, /*SecondsToWait=*/0,
+                          /*MemoryLimit=*/0, &ErrMsg) != 0) {
+    Diags.Report(DiagID) << (ErrMsg.empty() ? "partial link failed" : ErrMsg);
+    return false;
+  }
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Linked =
+      MemoryBuffer::getFile(LinkedFile);
+  if (!Linked) {
+    Diags.Report(DiagID) << Linked.getError().message();
+    return false;
+  }
+  OS << (*Linked)->getBuffer();
+  return true;
+}
+
 void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
                                       std::unique_ptr<raw_pwrite_stream> OS) {
   TimeRegion Region(FrontendTimesIsEnabled ? &CodeGenerationTime : nullptr);
@@ -776,6 +1162,16 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
       createTargetTransformInfoWrapperPass(getTargetIRAnalysis()));
 
   std::unique_ptr<llvm::ToolOutputFile> ThinLinkOS, DwoOS;
+  BackendMemoryReport MemReport(FrontendTimesIsEnabled);
+  bool ParallelCodeGen = shouldEmitObjectInParallel(Action);
+  // The parts are combined with a relocatable link, which is only known to
+  // produce the same object as serial code generation for ELF.
+  if (ParallelCodeGen &&
+      !llvm::Triple(TheModule->getTargetTriple()).isOSBinFormatELF()) {
+    Diags.Report(diag::warn_fe_parallel_codegen_unsupported)
+        << TheModule->getTargetTriple();
+    ParallelCodeGen = false;
+  }
 
   switch (Action) {
   case Backend_EmitNothing:
@@ -812,6 +1208,9 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
     break;
 
   default:
+    // The parts of the module get code generation passes of their own.
+    if (ParallelCodeGen)
+      break;
     if (!CodeGenOpts.SplitDwarfFile.empty()) {
       DwoOS = openOutputFile(CodeGenOpts.SplitDwarfFile);
       if (!DwoOS)
@@ -820,6 +1219,9 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
     if (!AddEmitPasses(CodeGenPasses, Action, *OS,
                        DwoOS ? &DwoOS->os() : nullptr))
       return;
+    if (CodeGenOpts.FreeIRAfterCodeGen || MemReport.isEnabled())
+      CodeGenPasses.add(new ReleaseEmittedFunction(
+          MemReport, CodeGenOpts.FreeIRAfterCodeGen));
   }
 
   // Before executing passes, print the final values of the LLVM options.
@@ -833,25 +1235,35 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
 
     PerFunctionPasses.doInitialization();
     for (Function &F : *TheModule)
-      if (!F.isDeclaration())
+      if (!F.isDeclaration()) {
         PerFunctionPasses.run(F);
+        MemReport.sample();
+      }
     PerFunctionPasses.doFinalization();
+    MemReport.endPhase("Per-function optimization");
   }
 
   {
     PrettyStackTraceString CrashInfo("Per-module optimization passes");
     PerModulePasses.run(*TheModule);
+    MemReport.endPhase("Per-module optimization and IR output");
   }
 
   {
     PrettyStackTraceString CrashInfo("Code generation");
-    CodeGenPasses.run(*TheModule);
+    if (ParallelCodeGen)
+      EmitObjectInParallel(*OS);
+    else
+      CodeGenPasses.run(*TheModule);
+    MemReport.endPhase("Code generation");
   }
 
   if (ThinLinkOS)
     ThinLinkOS->keep();
   if (DwoOS)
     DwoOS->keep();
+
+  MemReport.print(llvm::errs());
 }
 
 static PassBuilder::OptimizationLevel mapToLevel(const CodeGenOptions &Opts) {
@@ -1978,8 +1978,30 @@ static bool hasExplicitMemberDefinition(CXXRecordDecl::method_iterator I,
   return false;
 }
 
+/// Whether a class cannot be created without emitting code for one of its
+/// constructors, so that its description can be left to the translation units
+/// that emit them.
+static bool canUseCtorHoming(const CXXRecordDecl *RD) {
+  if (isa<ClassTemplatePartialSpecializationDecl>(RD))
+    return false;
+
+  if (RD->isLambda() || RD->isAggregate() ||
+      RD->hasTrivialDefaultConstructor() ||
+      RD->hasConstexprNonCopyMoveConstructor())
+    return false;
+
+  for (const CXXConstructorDecl *Ctor : RD->ctors()) {
+    if (Ctor->isCopyOrMoveConstructor())
+      continue;
+    if (!Ctor->isDeleted())
+      return true;
+  }
+  return false;
+}
+
 static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
-                                 bool DebugTypeExtRefs, const RecordDecl *RD,
+                                 bool DebugTypeExtRefs, bool CtorHoming,
+                                 const RecordDecl *RD,
                                  const LangOptions &LangOpts) {
   if (DebugTypeExtRefs && isDefinedInClangModule(RD->getDefinition()))
     return true;
@@ -2012,6 +2034,14 @@ static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
       !isClassOrMethodDLLImport(CXXDecl))
     return true;
 
+  // In constructor homing mode, only emit complete debug info for a class
+  // when one of its constructors is emitted. Skip dllimport classes, whose
+  // constructors are emitted in another DLL, for the same reason as above.
+  if (CtorHoming && CXXDecl->hasDefinition() &&
+      canUseCtorHoming(CXXDecl->getDefinition()) &&
+      !isClassOrMethodDLLImport(CXXDecl))
+    return true;
+
   TemplateSpecializationKind Spec = TSK_Undeclared;
   if (const auto *SD = dyn_cast<ClassTemplateSpecializationDecl>(RD))
     Spec = SD->getSpecializationKind();
@@ -2024,8 +2054,17 @@ static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
   return false;
 }
 
+void CGDebugInfo::completeConstructedClass(const CXXConstructorDecl *CD) {
+  const CXXRecordDecl *RD = CD->getParent();
+  if (!CGM.getCodeGenOpts().DebugCtorHoming || !canUseCtorHoming(RD))
+    return;
+  completeClassData(RD);
+}
+
 void CGDebugInfo::completeRequiredType(const RecordDecl *RD) {
-  if (shouldOmitDefinition(DebugKind, DebugTypeExtRefs, RD, CGM.getLangOpts()))
+  if (shouldOmitDefinition(DebugKind, DebugTypeExtRefs,
+                           CGM.getCodeGenOpts().DebugCtorHoming, RD,
+                           CGM.getLangOpts()))
     return;
 
   QualType Ty = CGM.getContext().getRecordType(RD);
@@ -2037,7 +2076,8 @@ void CGDebugInfo::completeRequiredType(const RecordDecl *RD) {
 llvm::DIType *CGDebugInfo::CreateType(const RecordType *Ty) {
   RecordDecl *RD = Ty->getDecl();
   llvm::DIType *T = cast_or_null<llvm::DIType>(getTypeOrNull(QualType(Ty, 0)));
-  if (T || shouldOmitDefinition(DebugKind, DebugTypeExtRefs, RD,
+  if (T || shouldOmitDefinition(DebugKind, DebugTypeExtRefs,
+                                CGM.getCodeGenOpts().DebugCtorHoming, RD,
                                 CGM.getLangOpts())) {
     if (!T)
       T = getOrCreateRecordFwdDecl(Ty, getDeclContextDescriptor(RD));
@@ -469,6 +469,11 @@ public:
   void completeClassData(const RecordDecl *RD);
   void completeClass(const RecordDecl *RD);
 
+  /// Emit the complete description of the class of a constructor that is
+  /// being emitted, if the class is only described where its constructors
+  /// are emitted.
+  void completeConstructedClass(const CXXConstructorDecl *CD);
+
   void completeTemplateDefinition(const ClassTemplateSpecializationDecl &SD);
   void completeUnusedClass(const CXXRecordDecl &D);
 
@@ -66,6 +66,9 @@ struct LoopAttributes {
 
   /// Value for llvm.loop.distribute.enable metadata.
   LVEnableState DistributeEnable;
+
+  /// Value for llvm.loop.vectorize.predicate.enable metadata.
+  LVEnableState VectorizePredicateEnable;
 };
 
 /// Information used when generating a structured loop.
@@ -138,6 +141,12 @@ public:
         Enable ? LoopAttributes::Enable : LoopAttributes::Disable;
   }
 
+  /// Set the next pushed loop 'vectorize.predicate.enable'
+  void setVectorizePredicateState(bool Enable = true) {
+    StagedAttrs.VectorizePredicateEnable =
+        Enable ? LoopAttributes::Enable : LoopAttributes::Disable;
+  }
+
   /// Set the next pushed loop as a distribution candidate.
   void setDistributeState(bool Enable = true) {
     StagedAttrs.DistributeEnable =
@@ -44,6 +44,7 @@
 #include "clang/CodeGen/ConstantInitBuilder.h"
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Sema/SemaDiagnostic.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/IR/CallSite.h"
@@ -60,6 +61,11 @@
 using namespace clang;
 using namespace CodeGen;
 
+#define DEBUG_TYPE "codegenmodule"
+
+STATISTIC(NumExternalDefinitionsSkipped,
+          "The # of functions left to the object file of a module or PCH");
+
 static llvm::cl::opt<bool> LimitedCoverage(
     "limited-coverage-experimental", llvm::cl::ZeroOrMore, llvm::cl::Hidden,
     llvm::cl::desc("Emit limited coverage mapping information (experimental)"),
@@ -89,11 +95,12 @@ CodeGenModule::CodeGenModule(ASTContext &C, const HeaderSearchOptions &HSO,
                              const PreprocessorOptions &PPO,
                              const CodeGenOptions &CGO, llvm::Module &M,
                              DiagnosticsEngine &diags,
-                             CoverageSourceInfo *CoverageInfo)
+                             CoverageSourceInfo *CoverageInfo,
+                             RecordLayoutCache *SharedLayouts)
     : Context(C), LangOpts(C.getLangOpts()), HeaderSearchOpts(HSO),
       PreprocessorOpts(PPO), CodeGenOpts(CGO), TheModule(M), Diags(diags),
       Target(C.getTargetInfo()), ABI(createCXXABI(*this)),
-      VMContext(M.getContext()), Types(*this), VTables(*this),
+      VMContext(M.getContext()), Types(*this, SharedLayouts), VTables(*this),
       SanitizerMD(new SanitizerMetadata(*this)) {
 
   // Initialize the type cache.
@@ -2347,6 +2354,17 @@ bool CodeGenModule::shouldEmitFunction(GlobalDecl GD) {
   if (CodeGenOpts.OptimizationLevel == 0 && !F->hasAttr<AlwaysInlineAttr>())
     return false;
 
+  // Another copy of a function owned by a module or PCH object file is only
+  // useful for inlining. Leave it to that object file when asked to.
+  if (CodeGenOpts.SkipModulesCodegenDefinitions &&
+      !F->hasAttr<AlwaysInlineAttr>()) {
+    if (ExternalASTSource *ES = getContext().getExternalSource())
+      if (ES->hasExternalDefinitions(F) == ExternalASTSource::EK_Always) {
+        ++NumExternalDefinitionsSkipped;
+        return false;
+      }
+  }
+
   if (F->hasAttr<DLLImportAttr>()) {
     // Check whether it would be safe to inline this dllimport function.
     DLLImportFunctionVisitor Visitor;
@@ -2395,12 +2413,15 @@ void CodeGenModule::EmitGlobalDefinition(GlobalDecl GD, llvm::GlobalValue *GV) {
     if (const auto *Method = dyn_cast<CXXMethodDecl>(D)) {
       // Make sure to emit the definition(s) before we emit the thunks.
       // This is necessary for the generation of certain thunks.
-      if (const auto *CD = dyn_cast<CXXConstructorDecl>(Method))
+      if (const auto *CD = dyn_cast<CXXConstructorDecl>(Method)) {
         ABI->emitCXXStructor(CD, getFromCtorType(GD.getCtorType()));
-      else if (const auto *DD = dyn_cast<CXXDestructorDecl>(Method))
+        if (CGDebugInfo *DI = getModuleDebugInfo())
+          DI->completeConstructedClass(CD);
+      } else if (const auto *DD = dyn_cast<CXXDestructorDecl>(Method)) {
         ABI->emitCXXStructor(DD, getFromDtorType(GD.getDtorType()));
-      else
+      } else {
         EmitGlobalFunctionDefinition(GD, GV);
+      }
 
       if (Method->isVirtual())
         getVTables().EmitThunks(GD);
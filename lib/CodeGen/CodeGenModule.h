@@ -518,7 +518,8 @@ public:
                 const PreprocessorOptions &ppopts,
                 const CodeGenOptions &CodeGenOpts, llvm::Module &M,
                 DiagnosticsEngine &Diags,
-                CoverageSourceInfo *CoverageInfo = nullptr);
+                CoverageSourceInfo *CoverageInfo = nullptr,
+                RecordLayoutCache *SharedLayouts = nullptr);
 
   ~CodeGenModule();
 
@@ -16,12 +16,22 @@
 #include "CoverageMappingGen.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/StmtVisitor.h"
+#include "clang/Basic/StatisticTimer.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/MDBuilder.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
 
+#define DEBUG_TYPE "codegenpgo"
+
+STATISTIC(NumProfileLookups, "Number of functions looked up in the profile");
+STATISTIC(NumProfileRecordsUsed,
+          "Number of functions whose profile record matched");
+STATISTIC(ProfileLookupMicroseconds,
+          "Time spent looking up functions in the profile (us)");
+
 static llvm::cl::opt<bool>
     EnableValueProfiling("enable-value-profiling", llvm::cl::ZeroOrMore,
                          llvm::cl::desc("Enable value profiling"),
@@ -782,7 +792,10 @@ void CodeGenPGO::assignRegionCounters(GlobalDecl GD, llvm::Function *Fn) {
   if (PGOReader) {
     SourceManager &SM = CGM.getContext().getSourceManager();
     loadRegionCounts(PGOReader, SM.isInMainFile(D->getLocation()));
-    computeRegionCounts(D);
+    // Without usable counts every statement count would be zero, which is
+    // what the absence of the count map already means.
+    if (haveRegionCounts())
+      computeRegionCounts(D);
     applyFunctionAttributes(PGOReader, Fn);
   }
 }
@@ -956,12 +969,21 @@ void CodeGenPGO::valueProfile(CGBuilderTy &Builder, uint32_t ValueKind,
   }
 }
 
+static llvm::Expected<llvm::InstrProfRecord>
+lookupProfileRecord(llvm::IndexedInstrProfReader *PGOReader, StringRef FuncName,
+                    uint64_t FunctionHash) {
+  ++NumProfileLookups;
+  return timeForStatistics(
+      [&] { return PGOReader->getInstrProfRecord(FuncName, FunctionHash); },
+      [](unsigned Microseconds) { ProfileLookupMicroseconds += Microseconds; });
+}
+
 void CodeGenPGO::loadRegionCounts(llvm::IndexedInstrProfReader *PGOReader,
                                   bool IsInMainFile) {
   CGM.getPGOStats().addVisited(IsInMainFile);
   RegionCounts.clear();
   llvm::Expected<llvm::InstrProfRecord> RecordExpected =
-      PGOReader->getInstrProfRecord(FuncName, FunctionHash);
+      lookupProfileRecord(PGOReader, FuncName, FunctionHash);
   if (auto E = RecordExpected.takeError()) {
     auto IPE = llvm::InstrProfError::take(std::move(E));
     if (IPE == llvm::instrprof_error::unknown_function)
@@ -973,9 +995,13 @@ void CodeGenPGO::loadRegionCounts(llvm::IndexedInstrProfReader *PGOReader,
       CGM.getPGOStats().addMismatched(IsInMainFile);
     return;
   }
-  ProfRecord =
-      llvm::make_unique<llvm::InstrProfRecord>(std::move(RecordExpected.get()));
-  RegionCounts = ProfRecord->Counts;
+  ++NumProfileRecordsUsed;
+  RegionCounts = std::move(RecordExpected->Counts);
+  // The rest of the record is only read to annotate value sites, so don't
+  // hold on to its value data otherwise.
+  if (EnableValueProfiling)
+    ProfRecord = llvm::make_unique<llvm::InstrProfRecord>(
+        std::move(RecordExpected.get()));
 }
 
 /// Calculate what to divide by to scale weights.
@@ -23,21 +23,51 @@
 #include "clang/AST/Expr.h"
 #include "clang/AST/RecordLayout.h"
 #include "clang/CodeGen/CGFunctionInfo.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Module.h"
 using namespace clang;
 using namespace CodeGen;
 
-CodeGenTypes::CodeGenTypes(CodeGenModule &cgm)
+#define DEBUG_TYPE "codegentypes"
+
+STATISTIC(NumReusedRecordLayouts,
+          "Number of record layouts reused from an earlier module");
+
+RecordLayoutCache::RecordLayoutCache() = default;
+RecordLayoutCache::~RecordLayoutCache() = default;
+
+void RecordLayoutCache::setContext(llvm::LLVMContext &C) {
+  if (VMContext == &C)
+    return;
+  Layouts.clear();
+  VMContext = &C;
+}
+
+CGRecordLayout *RecordLayoutCache::lookup(const Type *Key) const {
+  auto I = Layouts.find(Key);
+  return I == Layouts.end() ? nullptr : I->second.get();
+}
+
+void RecordLayoutCache::add(const Type *Key, CGRecordLayout *Layout) {
+  assert(!Layout->getLLVMType()->isOpaque() &&
+         "sharing the layout of an incomplete record");
+  Layouts[Key].reset(Layout);
+}
+
+CodeGenTypes::CodeGenTypes(CodeGenModule &cgm, RecordLayoutCache *SharedLayouts)
   : CGM(cgm), Context(cgm.getContext()), TheModule(cgm.getModule()),
     Target(cgm.getTarget()), TheCXXABI(cgm.getCXXABI()),
-    TheABIInfo(cgm.getTargetCodeGenInfo().getABIInfo()) {
+    TheABIInfo(cgm.getTargetCodeGenInfo().getABIInfo()),
+    SharedLayouts(SharedLayouts) {
   SkippedLayout = false;
 }
 
 CodeGenTypes::~CodeGenTypes() {
-  llvm::DeleteContainerSeconds(CGRecordLayouts);
+  // Shared layouts are owned by the cache.
+  if (!SharedLayouts)
+    llvm::DeleteContainerSeconds(CGRecordLayouts);
 
   for (llvm::FoldingSet<CGFunctionInfo>::iterator
        I = FunctionInfos.begin(), E = FunctionInfos.end(); I != E; )
@@ -697,6 +727,15 @@ llvm::StructType *CodeGenTypes::ConvertRecordDeclType(const RecordDecl *RD) {
 
   llvm::StructType *&Entry = RecordDeclTypes[Key];
 
+  // Reuse the type and the layout computed by an earlier module, if any.
+  if (!Entry && SharedLayouts) {
+    if (CGRecordLayout *Layout = SharedLayouts->lookup(Key)) {
+      CGRecordLayouts[Key] = Layout;
+      ++NumReusedRecordLayouts;
+      return Entry = Layout->getLLVMType();
+    }
+  }
+
   // If we don't have a StructType at all yet, create the forward declaration.
   if (!Entry) {
     Entry = llvm::StructType::create(getLLVMContext());
@@ -733,6 +772,8 @@ llvm::StructType *CodeGenTypes::ConvertRecordDeclType(const RecordDecl *RD) {
   // Layout fields.
   CGRecordLayout *Layout = ComputeRecordLayout(RD, Ty);
   CGRecordLayouts[Key] = Layout;
+  if (SharedLayouts)
+    SharedLayouts->add(Key, Layout);
 
   // We're done laying out this struct.
   bool EraseResult = RecordsBeingLaidOut.erase(Key); (void)EraseResult;
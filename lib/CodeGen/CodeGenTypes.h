@@ -20,6 +20,7 @@
 #include "clang/Sema/Sema.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/Module.h"
+#include <memory>
 
 namespace llvm {
 class FunctionType;
@@ -115,6 +116,30 @@ inline StructorType getFromDtorType(CXXDtorType T) {
   llvm_unreachable("not a CXXDtorType");
 }
 
+/// The LLVM types and layouts of the records of an ASTContext, kept across
+/// the CodeGenModules that incremental code generation creates one after the
+/// other for it. Record types belong to the LLVMContext rather than to a
+/// module, so a later module in the same context can reuse them as they are.
+class RecordLayoutCache {
+  llvm::LLVMContext *VMContext = nullptr;
+  llvm::DenseMap<const Type *, std::unique_ptr<CGRecordLayout>> Layouts;
+
+public:
+  RecordLayoutCache();
+  ~RecordLayoutCache();
+
+  /// Prepare the cache for a module in the given context, dropping the
+  /// records of another context.
+  void setContext(llvm::LLVMContext &C);
+
+  /// Return the layout computed earlier for the record type \p Key, or null
+  /// if the record hasn't been laid out yet.
+  CGRecordLayout *lookup(const Type *Key) const;
+
+  /// Add the layout of a complete record, taking ownership of it.
+  void add(const Type *Key, CGRecordLayout *Layout);
+};
+
 /// This class organizes the cross-module state that is used while lowering
 /// AST types to LLVM types.
 class CodeGenTypes {
@@ -141,6 +166,10 @@ class CodeGenTypes {
   /// Contains the LLVM IR type for any converted RecordDecl.
   llvm::DenseMap<const Type*, llvm::StructType *> RecordDeclTypes;
 
+  /// Record types and layouts shared with the other modules generated from
+  /// the same ASTContext, if any. They own the layouts computed here.
+  RecordLayoutCache *SharedLayouts;
+
   /// Hold memoized CGFunctionInfo results.
   llvm::FoldingSet<CGFunctionInfo> FunctionInfos;
 
@@ -165,7 +194,7 @@ class CodeGenTypes {
   llvm::SmallSet<const Type *, 8> RecordsWithOpaqueMemberPointers;
 
 public:
-  CodeGenTypes(CodeGenModule &cgm);
+  CodeGenTypes(CodeGenModule &cgm, RecordLayoutCache *SharedLayouts = nullptr);
   ~CodeGenTypes();
 
   const llvm::DataLayout &getDataLayout() const {
@@ -16,6 +16,7 @@
 #include "clang/AST/StmtVisitor.h"
 #include "clang/Lex/Lexer.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ProfileData/Coverage/CoverageMapping.h"
@@ -29,6 +30,12 @@ using namespace clang;
 using namespace CodeGen;
 using namespace llvm::coverage;
 
+#define DEBUG_TYPE "coverage-mapping"
+
+STATISTIC(NumFunctionRecords, "Number of function coverage records emitted");
+STATISTIC(FilenamesBytes, "Size of the coverage filenames tables (bytes)");
+STATISTIC(MappingBytes, "Size of the encoded coverage mappings (bytes)");
+
 void CoverageSourceInfo::SourceRangeSkipped(SourceRange Range, SourceLocation) {
   SkippedRanges.push_back(Range);
 }
@@ -1280,6 +1287,8 @@ static void dump(llvm::raw_ostream &OS, StringRef FunctionName,
 void CoverageMappingModuleGen::addFunctionMappingRecord(
     llvm::GlobalVariable *NamePtr, StringRef NameValue, uint64_t FuncHash,
     const std::string &CoverageMapping, bool IsUsed) {
+  ++NumFunctionRecords;
+
   llvm::LLVMContext &Ctx = CGM.getLLVMContext();
   if (!FunctionRecordTy) {
 #define COVMAP_FUNC_RECORD(Type, LLVMType, Name, Init) LLVMType,
@@ -1348,11 +1357,14 @@ void CoverageMappingModuleGen::emit() {
   std::string FilenamesAndCoverageMappings;
   llvm::raw_string_ostream OS(FilenamesAndCoverageMappings);
   CoverageFilenamesSectionWriter(FilenameRefs).write(OS);
-  std::string RawCoverageMappings =
-      llvm::join(CoverageMappings.begin(), CoverageMappings.end(), "");
-  OS << RawCoverageMappings;
-  size_t CoverageMappingSize = RawCoverageMappings.size();
-  size_t FilenamesSize = OS.str().size() - CoverageMappingSize;
+  size_t FilenamesSize = OS.tell();
+  // Write the mappings straight after the filenames rather than joining them
+  // into another copy first.
+  for (const std::string &CoverageMapping : CoverageMappings)
+    OS << CoverageMapping;
+  size_t CoverageMappingSize = OS.tell() - FilenamesSize;
+  FilenamesBytes += FilenamesSize;
+  MappingBytes += CoverageMappingSize;
   // Append extra zeroes if necessary to ensure that the size of the filenames
   // and coverage mappings is a multiple of 8.
   if (size_t Rem = OS.str().size() % 8) {
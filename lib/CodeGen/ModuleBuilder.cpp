@@ -59,6 +59,10 @@ namespace {
 
     CoverageSourceInfo *CoverageInfo;
 
+    /// Record layouts reused by the modules started after the first one.
+    /// This must outlive the CodeGenModules that refer to it.
+    CodeGen::RecordLayoutCache RecordLayouts;
+
   protected:
     std::unique_ptr<llvm::Module> M;
     std::unique_ptr<CodeGen::CodeGenModule> Builder;
@@ -132,9 +136,11 @@ namespace {
 
       M->setTargetTriple(Ctx->getTargetInfo().getTriple().getTriple());
       M->setDataLayout(Ctx->getTargetInfo().getDataLayout());
+      RecordLayouts.setContext(M->getContext());
       Builder.reset(new CodeGen::CodeGenModule(Context, HeaderSearchOpts,
                                                PreprocessorOpts, CodeGenOpts,
-                                               *M, Diags, CoverageInfo));
+                                               *M, Diags, CoverageInfo,
+                                               &RecordLayouts));
 
       for (auto &&Lib : CodeGenOpts.DependentLibraries)
         Builder->AddDependentLib(Lib);
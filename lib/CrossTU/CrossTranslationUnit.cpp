@@ -23,10 +23,12 @@
 #include "llvm/ADT/Triple.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
-#include <fstream>
+#include <algorithm>
 #include <sstream>
+#include <tuple>
 
 namespace clang {
 namespace cross_tu {
@@ -61,6 +63,29 @@ public:
 };
 
 static llvm::ManagedStatic<IndexErrorCategory> Category;
+
+/// An importer that notes whether it copied attributes. Attributes are copied
+/// without their arguments, such as expressions and identifiers, so the
+/// declarations they are attached to keep referring to the source AST.
+class CrossTUImporter : public ASTImporter {
+public:
+  CrossTUImporter(ASTContext &ToContext, FileManager &ToFileManager,
+                  ASTContext &FromContext, FileManager &FromFileManager)
+      : ASTImporter(ToContext, ToFileManager, FromContext, FromFileManager,
+                    /*MinimalImport=*/false) {}
+
+  using ASTImporter::Import;
+
+  Attr *Import(const Attr *FromAttr) override {
+    ImportedAttrs = true;
+    return ASTImporter::Import(FromAttr);
+  }
+
+  bool importedAttrs() const { return ImportedAttrs; }
+
+private:
+  bool ImportedAttrs = false;
+};
 } // end anonymous namespace
 
 char IndexError::ID;
@@ -75,18 +100,23 @@ std::error_code IndexError::convertToErrorCode() const {
 
 llvm::Expected<llvm::StringMap<std::string>>
 parseCrossTUIndex(StringRef IndexPath, StringRef CrossTUDir) {
-  std::ifstream ExternalFnMapFile(IndexPath);
-  if (!ExternalFnMapFile)
+  // The index of a large project has a line for every external definition.
+  // Map it into memory rather than reading it through a stream.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> BufferOrErr =
+      llvm::MemoryBuffer::getFile(IndexPath, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!BufferOrErr)
     return llvm::make_error<IndexError>(index_error_code::missing_index_file,
                                         IndexPath.str());
 
   llvm::StringMap<std::string> Result;
-  std::string Line;
+  StringRef Remaining = (*BufferOrErr)->getBuffer();
   unsigned LineNo = 1;
-  while (std::getline(ExternalFnMapFile, Line)) {
-    const size_t Pos = Line.find(" ");
-    if (Pos > 0 && Pos != std::string::npos) {
-      StringRef LineRef{Line};
+  while (!Remaining.empty()) {
+    StringRef LineRef;
+    std::tie(LineRef, Remaining) = Remaining.split('\n');
+    const size_t Pos = LineRef.find(' ');
+    if (Pos > 0 && Pos != StringRef::npos) {
       StringRef FunctionLookupName = LineRef.substr(0, Pos);
       if (Result.count(FunctionLookupName))
         return llvm::make_error<IndexError>(
@@ -155,6 +185,13 @@ CrossTranslationUnitContext::getCrossTUDefinition(const FunctionDecl *FD,
   if (LookupFnName.empty())
     return llvm::make_error<IndexError>(
         index_error_code::failed_to_generate_usr);
+
+  // Every top-level function that calls FD asks for its definition again.
+  // Once imported, the definition does not depend on the external AST.
+  auto Imported = ImportedFunctionMap.find(LookupFnName);
+  if (Imported != ImportedFunctionMap.end())
+    return Imported->second;
+
   llvm::Expected<ASTUnit *> ASTUnitOrError =
       loadExternalAST(LookupFnName, CrossTUDir, IndexName);
   if (!ASTUnitOrError)
@@ -168,8 +205,13 @@ CrossTranslationUnitContext::getCrossTUDefinition(const FunctionDecl *FD,
 
   TranslationUnitDecl *TU = Unit->getASTContext().getTranslationUnitDecl();
   if (const FunctionDecl *ResultDecl =
-          findFunctionInDeclContext(TU, LookupFnName))
-    return importDefinition(ResultDecl);
+          findFunctionInDeclContext(TU, LookupFnName)) {
+    llvm::Expected<const FunctionDecl *> ToDeclOrError =
+        importDefinition(ResultDecl);
+    if (ToDeclOrError)
+      ImportedFunctionMap[LookupFnName] = *ToDeclOrError;
+    return ToDeclOrError;
+  }
   return llvm::make_error<IndexError>(index_error_code::failed_import);
 }
 
@@ -233,16 +275,90 @@ llvm::Expected<ASTUnit *> CrossTranslationUnitContext::loadExternalAST(
           ASTUnit::LoadEverything, Diags, CI.getFileSystemOpts()));
       Unit = LoadedUnit.get();
       FileASTUnitMap[ASTFileName] = std::move(LoadedUnit);
+      if (Unit) {
+        ASTUnitsByUse.push_back(Unit);
+        enforceASTMemoryBudget(Unit);
+      }
     } else {
       Unit = ASTCacheEntry->second.get();
+      if (Unit)
+        touchASTUnit(Unit);
     }
     FunctionASTUnitMap[LookupName] = Unit;
   } else {
     Unit = FnUnitCacheEntry->second;
+    if (Unit)
+      touchASTUnit(Unit);
   }
   return Unit;
 }
 
+/// Estimate the memory held by a loaded AST.
+static uint64_t getASTUnitMemory(const ASTUnit &Unit) {
+  const ASTContext &Ctx = Unit.getASTContext();
+  return Ctx.getASTAllocatedMemory() + Ctx.getSideTableAllocatedMemory() +
+         Ctx.getSourceManager().getMemoryBufferSizes().malloc_bytes;
+}
+
+void CrossTranslationUnitContext::touchASTUnit(ASTUnit *Unit) {
+  auto It = std::find(ASTUnitsByUse.begin(), ASTUnitsByUse.end(), Unit);
+  assert(It != ASTUnitsByUse.end() && "Unit is not loaded");
+  std::rotate(It, std::next(It), ASTUnitsByUse.end());
+}
+
+void CrossTranslationUnitContext::enforceASTMemoryBudget(const ASTUnit *Keep) {
+  if (!ASTMemoryBudget)
+    return;
+
+  // The ASTs are deserialized lazily and grow while definitions are imported
+  // from them, so measure them anew each time.
+  uint64_t TotalMemory = 0;
+  for (const ASTUnit *Unit : ASTUnitsByUse)
+    TotalMemory += getASTUnitMemory(*Unit);
+
+  // The ASTs that the imported declarations may still refer to cannot be
+  // unloaded.
+  SmallVector<ASTUnit *, 8> Victims;
+  for (ASTUnit *Unit : ASTUnitsByUse) {
+    if (TotalMemory <= ASTMemoryBudget)
+      break;
+    if (Unit == Keep || isReferredToByImports(*Unit))
+      continue;
+    TotalMemory -= getASTUnitMemory(*Unit);
+    Victims.push_back(Unit);
+  }
+  for (ASTUnit *Victim : Victims)
+    unloadASTUnit(Victim);
+}
+
+bool CrossTranslationUnitContext::isReferredToByImports(
+    const ASTUnit &Unit) const {
+  auto I =
+      ASTUnitImporterMap.find(Unit.getASTContext().getTranslationUnitDecl());
+  return I != ASTUnitImporterMap.end() &&
+         static_cast<const CrossTUImporter &>(*I->second).importedAttrs();
+}
+
+void CrossTranslationUnitContext::unloadASTUnit(ASTUnit *Unit) {
+  for (auto It = FunctionASTUnitMap.begin(), E = FunctionASTUnitMap.end();
+       It != E;) {
+    auto Current = It++;
+    if (Current->second == Unit)
+      FunctionASTUnitMap.erase(Current);
+  }
+  assert(!isReferredToByImports(*Unit) && "Unloading an AST still referred to");
+  ASTUnitImporterMap.erase(Unit->getASTContext().getTranslationUnitDecl());
+  ASTUnitsByUse.erase(
+      std::find(ASTUnitsByUse.begin(), ASTUnitsByUse.end(), Unit));
+  for (auto It = FileASTUnitMap.begin(), E = FileASTUnitMap.end(); It != E;
+       ++It) {
+    if (It->second.get() == Unit) {
+      FileASTUnitMap.erase(It);
+      break;
+    }
+  }
+}
+
 llvm::Expected<const FunctionDecl *>
 CrossTranslationUnitContext::importDefinition(const FunctionDecl *FD) {
   ASTImporter &Importer = getOrCreateASTImporter(FD->getASTContext());
@@ -259,8 +375,8 @@ CrossTranslationUnitContext::getOrCreateASTImporter(ASTContext &From) {
   if (I != ASTUnitImporterMap.end())
     return *I->second;
   ASTImporter *NewImporter =
-      new ASTImporter(Context, Context.getSourceManager().getFileManager(),
-                      From, From.getSourceManager().getFileManager(), false);
+      new CrossTUImporter(Context, Context.getSourceManager().getFileManager(),
+                          From, From.getSourceManager().getFileManager());
   ASTUnitImporterMap[From.getTranslationUnitDecl()].reset(NewImporter);
   return *NewImporter;
 }
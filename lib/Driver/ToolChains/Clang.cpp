@@ -3309,6 +3309,14 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   if (Args.getLastArg(options::OPT_save_temps_EQ))
     Args.AddLastArg(CmdArgs, options::OPT_save_temps_EQ);
 
+  // The objects generated in parallel are combined with a partial link, which
+  // is done by running the driver again.
+  if (Args.getLastArg(options::OPT_fparallel_codegen_EQ)) {
+    Args.AddLastArg(CmdArgs, options::OPT_fparallel_codegen_EQ);
+    CmdArgs.push_back("-fparallel-codegen-linker");
+    CmdArgs.push_back(D.getClangProgramPath());
+  }
+
   // Embed-bitcode option.
   if (C.getDriver().embedBitcodeInObject() && !C.getDriver().isUsingLTO() &&
       (isa<BackendJobAction>(JA) || isa<AssembleJobAction>(JA))) {
@@ -994,6 +994,9 @@ public:
 
 class ASTUnitPreambleCallbacks : public PreambleCallbacks {
 public:
+  /// \param Hash The hash of the preamble that is being extended, if any.
+  explicit ASTUnitPreambleCallbacks(unsigned Hash = 0) : Hash(Hash) {}
+
   unsigned getHash() const { return Hash; }
 
   std::vector<Decl *> takeTopLevelDecls() { return std::move(TopLevelDecls); }
@@ -1030,7 +1033,7 @@ public:
   }
 
 private:
-  unsigned Hash = 0;
+  unsigned Hash;
   std::vector<Decl *> TopLevelDecls;
   std::vector<serialization::DeclID> TopLevelDeclIDs;
   llvm::SmallVector<ASTUnit::StandaloneDiagnostic, 4> PreambleDiags;
@@ -1311,6 +1314,7 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
       return MainFileBuffer;
     } else {
       Preamble.reset();
+      SharedPreambleEntry.reset();
       PreambleDiagnostics.clear();
       TopLevelDeclsInPreamble.clear();
       PreambleSrcLocCache.clear();
@@ -1332,9 +1336,44 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
   if (!AllowRebuild)
     return nullptr;
 
+  // Another main file may have built the same preamble already. Preambles
+  // built with skipped function bodies are not shared, as the invocation does
+  // not reflect that.
+  PreambleStore *Store =
+      SkipFunctionBodies == SkipFunctionBodiesScope::Preamble
+          ? nullptr
+          : SharedPreambles.get();
+  std::shared_ptr<const PreambleStore::Entry> Base;
+  if (Store) {
+    if (auto Shared = Store->findReusable(
+            PreambleInvocationIn, MainFileBuffer.get(), Bounds, VFS.get())) {
+      getDiagnostics().Reset();
+      ProcessWarningOptions(getDiagnostics(),
+                            PreambleInvocationIn.getDiagnosticOpts());
+      getDiagnostics().setNumWarnings(0);
+
+      Preamble = Shared->Preamble;
+      SharedPreambleEntry = Shared;
+      PreambleRebuildCounter = 1;
+      TopLevelDecls.clear();
+      TopLevelDeclsInPreamble = Shared->TopLevelDeclIDs;
+      NumWarningsInPreamble = 0;
+      checkAndRemoveNonDriverDiags(StoredDiagnostics);
+      if (CurrentTopLevelHashValue != Shared->TopLevelHash)
+        CompletionCacheTopLevelHashValue = 0;
+      PreambleTopLevelHashValue = CurrentTopLevelHashValue;
+      return MainFileBuffer;
+    }
+
+    // Otherwise, only parse what follows the largest shared preamble that
+    // this one starts with.
+    Base = Store->findExtendable(PreambleInvocationIn, MainFileBuffer.get(),
+                                 Bounds, VFS.get());
+  }
+
   SmallVector<StandaloneDiagnostic, 4> NewPreambleDiagsStandalone;
   SmallVector<StoredDiagnostic, 4> NewPreambleDiags;
-  ASTUnitPreambleCallbacks Callbacks;
+  ASTUnitPreambleCallbacks Callbacks(Base ? Base->TopLevelHash : 0);
   {
     llvm::Optional<CaptureDroppedDiagnostics> Capture;
     if (CaptureDiagnostics)
@@ -1350,19 +1389,36 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
     if (SkipFunctionBodies == SkipFunctionBodiesScope::Preamble)
       PreambleInvocationIn.getFrontendOpts().SkipFunctionBodies = true;
 
-    llvm::ErrorOr<PrecompiledPreamble> NewPreamble = PrecompiledPreamble::Build(
-        PreambleInvocationIn, MainFileBuffer.get(), Bounds, *Diagnostics, VFS,
-        PCHContainerOps, /*StoreInMemory=*/false, Callbacks);
+    llvm::ErrorOr<PrecompiledPreamble> NewPreamble =
+        BuildPreambleError::BaseCannotBeExtended;
+    if (Base) {
+      NewPreamble = PrecompiledPreamble::BuildExtension(
+          Base->Preamble, PreambleInvocationIn, MainFileBuffer.get(), Bounds,
+          *Diagnostics, VFS, PCHContainerOps, /*StoreInMemory=*/false,
+          Callbacks);
+      if (!NewPreamble) {
+        // Fall back to building the whole preamble.
+        Base.reset();
+        Callbacks = ASTUnitPreambleCallbacks();
+        NewPreambleDiags.clear();
+        NewPreambleDiagsStandalone.clear();
+      }
+    }
+    if (!Base)
+      NewPreamble = PrecompiledPreamble::Build(
+          PreambleInvocationIn, MainFileBuffer.get(), Bounds, *Diagnostics, VFS,
+          PCHContainerOps, /*StoreInMemory=*/false, Callbacks);
 
     PreambleInvocationIn.getFrontendOpts().SkipFunctionBodies =
         PreviousSkipFunctionBodies;
 
     if (NewPreamble) {
-      Preamble = std::move(*NewPreamble);
+      Preamble = std::make_shared<PrecompiledPreamble>(std::move(*NewPreamble));
       PreambleRebuildCounter = 1;
     } else {
       switch (static_cast<BuildPreambleError>(NewPreamble.getError().value())) {
       case BuildPreambleError::CouldntCreateTempFile:
+      case BuildPreambleError::BaseCannotBeExtended:
         // Try again next time.
         PreambleRebuildCounter = 1;
         return nullptr;
@@ -1381,6 +1437,10 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
 
   TopLevelDecls.clear();
   TopLevelDeclsInPreamble = Callbacks.takeTopLevelDeclIDs();
+  if (Base)
+    TopLevelDeclsInPreamble.insert(TopLevelDeclsInPreamble.begin(),
+                                   Base->TopLevelDeclIDs.begin(),
+                                   Base->TopLevelDeclIDs.end());
   PreambleTopLevelHashValue = Callbacks.getHash();
 
   NumWarningsInPreamble = getDiagnostics().getNumWarnings();
@@ -1389,6 +1449,17 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
   StoredDiagnostics = std::move(NewPreambleDiags);
   PreambleDiagnostics = std::move(NewPreambleDiagsStandalone);
 
+  // Diagnostics in the preamble refer to this main file, so only share
+  // preambles that produced none.
+  if (Store && NumWarningsInPreamble == 0 && PreambleDiagnostics.empty()) {
+    auto Entry = std::make_shared<PreambleStore::Entry>();
+    Entry->Preamble = Preamble;
+    Entry->TopLevelDeclIDs = TopLevelDeclsInPreamble;
+    Entry->TopLevelHash = PreambleTopLevelHashValue;
+    SharedPreambleEntry = Entry;
+    Store->insert(PreambleInvocationIn, std::move(Entry));
+  }
+
   // If the hash of top-level entities differs from the hash of the top-level
   // entities the last time we rebuilt the preamble, clear out the completion
   // cache.
@@ -1709,7 +1780,8 @@ ASTUnit *ASTUnit::LoadFromCommandLine(
     bool AllowPCHWithCompilerErrors, SkipFunctionBodiesScope SkipFunctionBodies,
     bool SingleFileParse, bool UserFilesAreVolatile, bool ForSerialization,
     llvm::Optional<StringRef> ModuleFormat, std::unique_ptr<ASTUnit> *ErrAST,
-    IntrusiveRefCntPtr<vfs::FileSystem> VFS) {
+    IntrusiveRefCntPtr<vfs::FileSystem> VFS,
+    std::shared_ptr<PreambleStore> SharedPreambles) {
   assert(Diags.get() && "no DiagnosticsEngine was provided");
 
   SmallVector<StoredDiagnostic, 4> StoredDiagnostics;
@@ -1767,6 +1839,7 @@ ASTUnit *ASTUnit::LoadFromCommandLine(
   AST->UserFilesAreVolatile = UserFilesAreVolatile;
   AST->Invocation = CI;
   AST->SkipFunctionBodies = SkipFunctionBodies;
+  AST->SharedPreambles = std::move(SharedPreambles);
   if (ForSerialization)
     AST->WriterData.reset(new ASTWriterData(*AST->PCMCache));
   // Zero out now to ease cleanup during crash recovery.
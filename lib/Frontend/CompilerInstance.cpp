@@ -377,6 +377,12 @@ void CompilerInstance::createPreprocessor(TranslationUnitKind TUKind) {
   if (!PPOpts.TokenCache.empty())
     PTHMgr = PTHManager::Create(PPOpts.TokenCache, getDiagnostics());
 
+  // Share module files with other compilations in the process, if asked to.
+  // Instances building modules share the importer's buffer cache, which
+  // already has it.
+  if (PPOpts.SharedModuleFiles && !getPCMCache().getSharedCache())
+    getPCMCache().setSharedCache(PPOpts.SharedModuleFiles);
+
   // Create the Preprocessor.
   HeaderSearch *HeaderInfo =
       new HeaderSearch(getHeaderSearchOptsPtr(), getSourceManager(),
@@ -75,6 +75,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Regex.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/VersionTuple.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetOptions.h"
@@ -600,6 +601,7 @@ static bool ParseCodeGenArgs(CodeGenOptions &Opts, ArgList &Args, InputKind IK,
   Opts.SplitDwarfInlining = !Args.hasArg(OPT_fno_split_dwarf_inlining);
   Opts.DebugTypeExtRefs = Args.hasArg(OPT_dwarf_ext_refs);
   Opts.DebugExplicitImport = Args.hasArg(OPT_dwarf_explicit_import);
+  Opts.DebugCtorHoming = Args.hasArg(OPT_fuse_ctor_homing);
   Opts.DebugFwdTemplateParams = Args.hasArg(OPT_debug_forward_template_params);
   Opts.EmbedSource = Args.hasArg(OPT_gembed_source);
 
@@ -722,6 +724,22 @@ static bool ParseCodeGenArgs(CodeGenOptions &Opts, ArgList &Args, InputKind IK,
   Opts.StrictReturn = !Args.hasArg(OPT_fno_strict_return);
   Opts.StrictVTablePointers = Args.hasArg(OPT_fstrict_vtable_pointers);
   Opts.ForceEmitVTables = Args.hasArg(OPT_fforce_emit_vtables);
+  Opts.SkipModulesCodegenDefinitions =
+      Args.hasArg(OPT_fskip_modules_codegen_definitions);
+  Opts.FreeIRAfterCodeGen = Args.hasArg(OPT_ffree_ir_after_codegen);
+  if (Arg *A = Args.getLastArg(OPT_fparallel_codegen_EQ)) {
+    int Jobs = getLastArgIntValue(Args, OPT_fparallel_codegen_EQ, 1, Diags);
+    if (Jobs <= 0) {
+      Diags.Report(diag::err_drv_invalid_value)
+          << A->getAsString(Args) << A->getValue();
+      Jobs = 1;
+    }
+    // More parts than threads only add splitting and linking work.
+    Opts.ParallelCodeGenJobs =
+        std::min(unsigned(Jobs), std::max(1u, llvm::hardware_concurrency()));
+  }
+  Opts.ParallelCodeGenLinker =
+      Args.getLastArgValue(OPT_fparallel_codegen_linker);
   Opts.UnsafeFPMath = Args.hasArg(OPT_menable_unsafe_fp_math) ||
                       Args.hasArg(OPT_cl_unsafe_math_optimizations) ||
                       Args.hasArg(OPT_cl_fast_relaxed_math);
@@ -0,0 +1,179 @@
+//===--- PreambleStore.cpp - Share preambles between main files -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the PreambleStore class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/PreambleStore.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/PrecompiledPreamble.h"
+#include "clang/Lex/HeaderSearchOptions.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace clang;
+
+std::string
+PreambleStore::getInvocationKey(const CompilerInvocation &Invocation) {
+  using llvm::hash_code;
+  using llvm::hash_combine;
+
+  // The module hash covers the language, target and most of the preprocessor
+  // options. Add the options that only matter for textual inclusion.
+  hash_code Code = llvm::hash_value(Invocation.getModuleHash());
+
+  const FrontendOptions &FEOpts = Invocation.getFrontendOpts();
+  Code = hash_combine(Code, FEOpts.SkipFunctionBodies);
+
+  // Quoted includes are resolved against the directory of the main file
+  // first, so only main files of the same directory can share preambles.
+  if (!FEOpts.Inputs.empty())
+    Code = hash_combine(
+        Code, llvm::sys::path::parent_path(FEOpts.Inputs[0].getFile()));
+
+  const PreprocessorOptions &PPOpts = Invocation.getPreprocessorOpts();
+  for (const auto &Macro : PPOpts.Macros)
+    Code = hash_combine(Code, Macro.first, Macro.second);
+  for (const auto &Include : PPOpts.Includes)
+    Code = hash_combine(Code, Include);
+  for (const auto &Include : PPOpts.MacroIncludes)
+    Code = hash_combine(Code, Include);
+  Code = hash_combine(Code, PPOpts.ImplicitPCHInclude);
+
+  const HeaderSearchOptions &HSOpts = Invocation.getHeaderSearchOpts();
+  for (const auto &Entry : HSOpts.UserEntries)
+    Code = hash_combine(Code, Entry.Path, static_cast<unsigned>(Entry.Group),
+                        Entry.IsFramework, Entry.IgnoreSysRoot);
+  for (const auto &Prefix : HSOpts.SystemHeaderPrefixes)
+    Code = hash_combine(Code, Prefix.Prefix, Prefix.IsSystemHeader);
+
+  // Relative includes are resolved against the working directory.
+  Code = hash_combine(Code, Invocation.getFileSystemOpts().WorkingDir);
+
+  // Warning flags decide which diagnostics the preamble produces.
+  const DiagnosticOptions &DiagOpts = Invocation.getDiagnosticOpts();
+  for (const auto &Warning : DiagOpts.Warnings)
+    Code = hash_combine(Code, Warning);
+
+  return llvm::APInt(64, Code).toString(36, /*Signed=*/false);
+}
+
+std::vector<std::shared_ptr<const PreambleStore::Entry>>
+PreambleStore::getLiveEntries(StringRef Key) {
+  std::vector<std::shared_ptr<const Entry>> Result;
+  auto Known = Entries.find(Key);
+  if (Known == Entries.end())
+    return Result;
+
+  auto &Candidates = Known->second;
+  for (auto I = Candidates.begin(); I != Candidates.end();) {
+    if (auto E = I->lock()) {
+      Result.push_back(std::move(E));
+      ++I;
+    } else {
+      I = Candidates.erase(I);
+    }
+  }
+  if (Candidates.empty())
+    Entries.erase(Known);
+  return Result;
+}
+
+std::shared_ptr<const PreambleStore::Entry>
+PreambleStore::findReusable(const CompilerInvocation &Invocation,
+                            const llvm::MemoryBuffer *MainFileBuffer,
+                            PreambleBounds Bounds, vfs::FileSystem *VFS) {
+  std::string Key = getInvocationKey(Invocation);
+  std::vector<std::shared_ptr<const Entry>> Candidates;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ++NumLookups;
+    Candidates = getLiveEntries(Key);
+  }
+
+  // Checking a candidate stats the files it depends on, so don't hold the
+  // lock while doing it.
+  for (const auto &E : Candidates) {
+    if (E->Preamble->CanReuse(Invocation, MainFileBuffer, Bounds, VFS)) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      ++NumReused;
+      return E;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const PreambleStore::Entry>
+PreambleStore::findExtendable(const CompilerInvocation &Invocation,
+                              const llvm::MemoryBuffer *MainFileBuffer,
+                              PreambleBounds Bounds, vfs::FileSystem *VFS) {
+  std::string Key = getInvocationKey(Invocation);
+  std::vector<std::shared_ptr<const Entry>> Candidates;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Candidates = getLiveEntries(Key);
+  }
+
+  // Prefer the largest base, as it leaves the least to parse.
+  std::sort(Candidates.begin(), Candidates.end(),
+            [](const std::shared_ptr<const Entry> &LHS,
+               const std::shared_ptr<const Entry> &RHS) {
+              return LHS->Preamble->getBounds().Size >
+                     RHS->Preamble->getBounds().Size;
+            });
+  for (const auto &E : Candidates) {
+    if (E->Preamble->CanExtend(Invocation, MainFileBuffer, Bounds, VFS)) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      ++NumExtended;
+      return E;
+    }
+  }
+  return nullptr;
+}
+
+void PreambleStore::insert(const CompilerInvocation &Invocation,
+                           std::shared_ptr<const Entry> E) {
+  assert(E && E->Preamble && "inserting an empty entry");
+  std::string Key = getInvocationKey(Invocation);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  ++NumInserted;
+  Entries[Key].push_back(std::move(E));
+}
+
+unsigned PreambleStore::getNumReused() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return NumReused;
+}
+
+unsigned PreambleStore::getNumExtended() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return NumExtended;
+}
+
+void PreambleStore::printStats(raw_ostream &OS) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  unsigned NumLive = 0;
+  for (const auto &Key : Entries)
+    for (const auto &E : Key.second)
+      if (!E.expired())
+        ++NumLive;
+
+  OS << "*** Preamble Store Stats:\n"
+     << "  " << NumLive << " live preambles\n"
+     << "  " << NumInserted << " preambles inserted\n"
+     << "  " << NumLookups << " lookups\n"
+     << "  " << NumReused << " preambles reused by another file\n"
+     << "  " << NumExtended << " preambles extended by another file\n";
+}
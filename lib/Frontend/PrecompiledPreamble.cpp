@@ -30,6 +30,7 @@
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/MutexGuard.h"
 #include "llvm/Support/Process.h"
+#include <atomic>
 #include <limits>
 #include <utility>
 
@@ -48,6 +49,13 @@ StringRef getInMemoryPreamblePath() {
 #endif
 }
 
+/// Returns a fresh path for an in-memory preamble, which does not clash with
+/// the path of any other in-memory preamble it might be chained to.
+std::string createInMemoryPreamblePath() {
+  static std::atomic<unsigned> NextID(0);
+  return (getInMemoryPreamblePath() + "-" + llvm::Twine(NextID++)).str();
+}
+
 IntrusiveRefCntPtr<vfs::FileSystem>
 createVFSOverlayForPreamblePCH(StringRef PCHFilename,
                                std::unique_ptr<llvm::MemoryBuffer> PCHBuffer,
@@ -127,7 +135,7 @@ void TemporaryFiles::removeFile(StringRef File) {
 
 class PrecompilePreambleAction : public ASTFrontendAction {
 public:
-  PrecompilePreambleAction(std::string *InMemStorage,
+  PrecompilePreambleAction(llvm::SmallVectorImpl<char> *InMemStorage,
                            PreambleCallbacks &Callbacks)
       : InMemStorage(InMemStorage), Callbacks(Callbacks) {}
 
@@ -150,7 +158,7 @@ private:
   friend class PrecompilePreambleConsumer;
 
   bool HasEmittedPreamblePCH = false;
-  std::string *InMemStorage;
+  llvm::SmallVectorImpl<char> *InMemStorage;
   PreambleCallbacks &Callbacks;
 };
 
@@ -174,13 +182,23 @@ public:
     if (!hasEmittedPCH())
       return;
 
-    // Write the generated bitstream to "Out".
-    *Out << getPCH();
-    // Make sure it hits disk now.
-    Out->flush();
-    // Free the buffer.
-    llvm::SmallVector<char, 0> Empty;
-    getPCH() = std::move(Empty);
+    if (Action.InMemStorage) {
+      // Take over the generated bitstream instead of copying it, so that we
+      // never hold two copies of the PCH.
+      *Action.InMemStorage = std::move(getPCH());
+      // The PCH is read back through buffers that require a null terminator,
+      // so keep one right past the end of the data.
+      Action.InMemStorage->push_back('\0');
+      Action.InMemStorage->pop_back();
+    } else {
+      // Write the generated bitstream to "Out".
+      *Out << getPCH();
+      // Make sure it hits disk now.
+      Out->flush();
+      // Free the buffer.
+      llvm::SmallVector<char, 0> Empty;
+      getPCH() = std::move(Empty);
+    }
 
     Action.setEmittedPreamblePCH(getWriter());
   }
@@ -197,15 +215,14 @@ PrecompilePreambleAction::CreateASTConsumer(CompilerInstance &CI,
   if (!GeneratePCHAction::ComputeASTConsumerArguments(CI, Sysroot))
     return nullptr;
 
+  // In-memory preambles take over the PCH buffer directly.
   std::unique_ptr<llvm::raw_ostream> OS;
-  if (InMemStorage) {
-    OS = llvm::make_unique<llvm::raw_string_ostream>(*InMemStorage);
-  } else {
+  if (!InMemStorage) {
     std::string OutputFile;
     OS = GeneratePCHAction::CreateOutputFile(CI, InFile, OutputFile);
+    if (!OS)
+      return nullptr;
   }
-  if (!OS)
-    return nullptr;
 
   if (!CI.getFrontendOpts().RelocatablePCH)
     Sysroot.clear();
@@ -235,6 +252,33 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
     DiagnosticsEngine &Diagnostics, IntrusiveRefCntPtr<vfs::FileSystem> VFS,
     std::shared_ptr<PCHContainerOperations> PCHContainerOps, bool StoreInMemory,
     PreambleCallbacks &Callbacks) {
+  return BuildImpl(Invocation, MainFileBuffer, Bounds, Diagnostics,
+                   std::move(VFS), std::move(PCHContainerOps), StoreInMemory,
+                   Callbacks, /*Base=*/nullptr);
+}
+
+llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::BuildExtension(
+    std::shared_ptr<const PrecompiledPreamble> Base,
+    const CompilerInvocation &Invocation,
+    const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
+    DiagnosticsEngine &Diagnostics, IntrusiveRefCntPtr<vfs::FileSystem> VFS,
+    std::shared_ptr<PCHContainerOperations> PCHContainerOps, bool StoreInMemory,
+    PreambleCallbacks &Callbacks) {
+  assert(Base && "Base is null");
+  if (!Base->CanExtend(Invocation, MainFileBuffer, Bounds, VFS.get()))
+    return BuildPreambleError::BaseCannotBeExtended;
+  return BuildImpl(Invocation, MainFileBuffer, Bounds, Diagnostics,
+                   std::move(VFS), std::move(PCHContainerOps), StoreInMemory,
+                   Callbacks, std::move(Base));
+}
+
+llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::BuildImpl(
+    const CompilerInvocation &Invocation,
+    const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
+    DiagnosticsEngine &Diagnostics, IntrusiveRefCntPtr<vfs::FileSystem> VFS,
+    std::shared_ptr<PCHContainerOperations> PCHContainerOps, bool StoreInMemory,
+    PreambleCallbacks &Callbacks,
+    std::shared_ptr<const PrecompiledPreamble> Base) {
   assert(VFS && "VFS is null");
 
   auto PreambleInvocation = std::make_shared<CompilerInvocation>(Invocation);
@@ -253,7 +297,10 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
     TempFile = std::move(*PreamblePCHFile);
   }
 
-  PCHStorage Storage = StoreInMemory ? PCHStorage(InMemoryPreamble())
+  InMemoryPreamble Memory;
+  if (StoreInMemory)
+    Memory.Path = createInMemoryPreamblePath();
+  PCHStorage Storage = StoreInMemory ? PCHStorage(std::move(Memory))
                                      : PCHStorage(std::move(*TempFile));
 
   // Save the preamble text for later; we'll need to compare against it for
@@ -265,13 +312,23 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
 
   // Tell the compiler invocation to generate a temporary precompiled header.
   FrontendOpts.ProgramAction = frontend::GeneratePCH;
-  FrontendOpts.OutputFile = StoreInMemory ? getInMemoryPreamblePath()
-                                          : Storage.asFile().getFilePath();
+  FrontendOpts.OutputFile = getPCHPath(Storage);
   PreprocessorOpts.PrecompiledPreambleBytes.first = 0;
   PreprocessorOpts.PrecompiledPreambleBytes.second = false;
   // Inform preprocessor to record conditional stack when building the preamble.
   PreprocessorOpts.GeneratePreamble = true;
 
+  // When extending a preamble, load the PCH of the base preamble and skip the
+  // part of the main file it covers. The PCH we write is chained to it.
+  if (Base) {
+    PreambleBounds BaseBounds = Base->getBounds();
+    PreprocessorOpts.PrecompiledPreambleBytes.first = BaseBounds.Size;
+    PreprocessorOpts.PrecompiledPreambleBytes.second =
+        BaseBounds.PreambleEndsAtStartOfLine;
+    PreprocessorOpts.DisablePCHValidation = true;
+    Base->setupPreambleStorageChain(PreprocessorOpts, VFS);
+  }
+
   // Create the compiler instance to use for building the precompiled preamble.
   std::unique_ptr<CompilerInstance> Clang(
       new CompilerInstance(std::move(PCHContainerOps)));
@@ -361,8 +418,15 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
   // so we can verify whether they have changed or not.
   llvm::StringMap<PrecompiledPreamble::PreambleFileHash> FilesInPreamble;
 
+  // The PCHs of base preambles are tracked by the base preambles themselves.
+  llvm::StringSet<> BasePCHs;
+  for (const PrecompiledPreamble *P = Base.get(); P; P = P->Base.get())
+    BasePCHs.insert(getPCHPath(P->Storage));
+
   SourceManager &SourceMgr = Clang->getSourceManager();
   for (auto &Filename : PreambleDepCollector->getDependencies()) {
+    if (BasePCHs.count(Filename))
+      continue;
     const FileEntry *File = Clang->getFileManager().getFile(Filename);
     if (!File || File == SourceMgr.getFileEntryForID(SourceMgr.getMainFileID()))
       continue;
@@ -377,9 +441,15 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
     }
   }
 
+  // An extension is only valid as long as its base is, so it has to track
+  // the files of the base too.
+  if (Base)
+    for (const auto &F : Base->FilesInPreamble)
+      FilesInPreamble.insert(std::make_pair(F.first(), F.second));
+
   return PrecompiledPreamble(std::move(Storage), std::move(PreambleBytes),
                              PreambleEndsAtStartOfLine,
-                             std::move(FilesInPreamble));
+                             std::move(FilesInPreamble), std::move(Base));
 }
 
 PreambleBounds PrecompiledPreamble::getBounds() const {
@@ -416,10 +486,6 @@ bool PrecompiledPreamble::CanReuse(const CompilerInvocation &Invocation,
       Bounds.Size <= MainFileBuffer->getBufferSize() &&
       "Buffer is too large. Bounds were calculated from a different buffer?");
 
-  auto PreambleInvocation = std::make_shared<CompilerInvocation>(Invocation);
-  PreprocessorOptions &PreprocessorOpts =
-      PreambleInvocation->getPreprocessorOpts();
-
   // We've previously computed a preamble. Check whether we have the same
   // preamble now that we did before, and that there's enough space in
   // the main-file buffer within the precompiled preamble to fit the
@@ -431,6 +497,48 @@ bool PrecompiledPreamble::CanReuse(const CompilerInvocation &Invocation,
     return false;
   // The preamble has not changed. We may be able to re-use the precompiled
   // preamble.
+  return filesInPreambleAreUnchanged(Invocation, VFS);
+}
+
+bool PrecompiledPreamble::CanExtend(const CompilerInvocation &Invocation,
+                                    const llvm::MemoryBuffer *MainFileBuffer,
+                                    PreambleBounds Bounds,
+                                    vfs::FileSystem *VFS) const {
+  assert(
+      Bounds.Size <= MainFileBuffer->getBufferSize() &&
+      "Buffer is too large. Bounds were calculated from a different buffer?");
+
+  // The new preamble must start with this one, and this one must end at the
+  // start of a line, so that the new part can be preprocessed on its own.
+  if (!PreambleEndsAtStartOfLine || PreambleBytes.size() >= Bounds.Size ||
+      memcmp(PreambleBytes.data(), MainFileBuffer->getBufferStart(),
+             PreambleBytes.size()) != 0)
+    return false;
+
+  return filesInPreambleAreUnchanged(Invocation, VFS);
+}
+
+std::error_code PrecompiledPreamble::WriteToFile(StringRef Path) const {
+  if (Base)
+    return std::make_error_code(std::errc::not_supported);
+
+  if (Storage.getKind() == PCHStorage::Kind::TempFile)
+    return llvm::sys::fs::copy_file(Storage.asFile().getFilePath(), Path);
+
+  std::error_code EC;
+  llvm::raw_fd_ostream Out(Path, EC, llvm::sys::fs::F_None);
+  if (EC)
+    return EC;
+  const llvm::SmallVector<char, 0> &Data = Storage.asMemory().Data;
+  Out.write(Data.data(), Data.size());
+  Out.close();
+  return Out.error();
+}
+
+bool PrecompiledPreamble::filesInPreambleAreUnchanged(
+    const CompilerInvocation &Invocation, vfs::FileSystem *VFS) const {
+  const PreprocessorOptions &PreprocessorOpts =
+      Invocation.getPreprocessorOpts();
 
   // Check that none of the files used by the preamble have changed.
   // First, make a record of those files that have been overridden via
@@ -501,10 +609,12 @@ void PrecompiledPreamble::OverridePreamble(
 PrecompiledPreamble::PrecompiledPreamble(
     PCHStorage Storage, std::vector<char> PreambleBytes,
     bool PreambleEndsAtStartOfLine,
-    llvm::StringMap<PreambleFileHash> FilesInPreamble)
+    llvm::StringMap<PreambleFileHash> FilesInPreamble,
+    std::shared_ptr<const PrecompiledPreamble> Base)
     : Storage(std::move(Storage)), FilesInPreamble(std::move(FilesInPreamble)),
       PreambleBytes(std::move(PreambleBytes)),
-      PreambleEndsAtStartOfLine(PreambleEndsAtStartOfLine) {
+      PreambleEndsAtStartOfLine(PreambleEndsAtStartOfLine),
+      Base(std::move(Base)) {
   assert(this->Storage.getKind() != PCHStorage::Kind::Empty);
 }
 
@@ -696,9 +806,27 @@ void PrecompiledPreamble::configurePreamble(
       Bounds.PreambleEndsAtStartOfLine;
   PreprocessorOpts.DisablePCHValidation = true;
 
+  setupPreambleStorageChain(PreprocessorOpts, VFS);
+}
+
+void PrecompiledPreamble::setupPreambleStorageChain(
+    PreprocessorOptions &PreprocessorOpts,
+    IntrusiveRefCntPtr<vfs::FileSystem> &VFS) const {
+  // The PCH of an extension refers to the PCH of its base by path, so all of
+  // them have to be accessible. The PCH of this preamble is set up last, so
+  // that it is the one that gets included.
+  if (Base)
+    Base->setupPreambleStorageChain(PreprocessorOpts, VFS);
   setupPreambleStorage(Storage, PreprocessorOpts, VFS);
 }
 
+StringRef PrecompiledPreamble::getPCHPath(const PCHStorage &Storage) {
+  if (Storage.getKind() == PCHStorage::Kind::TempFile)
+    return Storage.asFile().getFilePath();
+  assert(Storage.getKind() == PCHStorage::Kind::InMemory);
+  return Storage.asMemory().Path;
+}
+
 void PrecompiledPreamble::setupPreambleStorage(
     const PCHStorage &Storage, PreprocessorOptions &PreprocessorOpts,
     IntrusiveRefCntPtr<vfs::FileSystem> &VFS) {
@@ -726,11 +854,12 @@ void PrecompiledPreamble::setupPreambleStorage(
     assert(Storage.getKind() == PCHStorage::Kind::InMemory);
     // For in-memory preamble, we have to provide a VFS overlay that makes it
     // accessible.
-    StringRef PCHPath = getInMemoryPreamblePath();
-    PreprocessorOpts.ImplicitPCHInclude = PCHPath;
+    const InMemoryPreamble &Memory = Storage.asMemory();
+    PreprocessorOpts.ImplicitPCHInclude = Memory.Path;
 
-    auto Buf = llvm::MemoryBuffer::getMemBuffer(Storage.asMemory().Data);
-    VFS = createVFSOverlayForPreamblePCH(PCHPath, std::move(Buf), VFS);
+    auto Buf = llvm::MemoryBuffer::getMemBuffer(
+        StringRef(Memory.Data.data(), Memory.Data.size()), Memory.Path);
+    VFS = createVFSOverlayForPreamblePCH(Memory.Path, std::move(Buf), VFS);
   }
 }
 
@@ -760,6 +889,8 @@ std::string BuildPreambleErrorCategory::message(int condition) const {
     return "BeginSourceFile() return an error";
   case BuildPreambleError::CouldntEmitPCH:
     return "Could not emit PCH";
+  case BuildPreambleError::BaseCannotBeExtended:
+    return "Base preamble cannot be extended to the new preamble bounds";
   }
   llvm_unreachable("unexpected BuildPreambleError");
 }
@@ -53,6 +53,7 @@
 #include "clang/Basic/OperatorKinds.h"
 #include "clang/Basic/PragmaKinds.h"
 #include "clang/Basic/Sanitizers.h"
+#include "clang/Basic/SharedModuleCache.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/SourceManagerInternals.h"
@@ -103,6 +104,7 @@
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Bitcode/BitstreamReader.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/Chrono.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/DJB.h"
@@ -4101,6 +4103,15 @@ ASTReader::ASTReadResult ASTReader::ReadAST(StringRef FileName,
     }
   }
 
+  // Let other compilations sharing these module files know that they are up
+  // to date.
+  if (SharedModuleCache *Shared = PCMCache.getSharedCache()) {
+    time_t Now = llvm::sys::toTimeT(std::chrono::system_clock::now());
+    for (const ImportedModule &M : Loaded)
+      if (M.Mod->Kind == MK_ImplicitModule)
+        Shared->markValidated(M.Mod->FileName, Now);
+  }
+
   return Success;
 }
 
@@ -7707,6 +7718,12 @@ void ASTReader::PrintStats() {
                  "  %u / %u identifier table lookups succeeded (%f%%)\n",
                  NumIdentifierLookupHits, NumIdentifierLookups,
                  (double)NumIdentifierLookupHits*100.0/NumIdentifierLookups);
+  if (NumODRHashMergedDefinitions)
+    std::fprintf(stderr, "  %u definitions merged by ODR hash\n",
+                 NumODRHashMergedDefinitions);
+  if (NumSkippedOdrMergeChecks)
+    std::fprintf(stderr, "  %u ODR merge checks skipped by ODR hash\n",
+                 NumSkippedOdrMergeChecks);
 
   if (GlobalIndex) {
     std::fprintf(stderr, "\n");
@@ -9433,18 +9450,24 @@ void ASTReader::finishPendingActions() {
         auto *NonConstDefn = const_cast<FunctionDecl*>(Defn);
         mergeDefinitionVisibility(NonConstDefn, FD);
 
-        if (!FD->isLateTemplateParsed() &&
-            !NonConstDefn->isLateTemplateParsed() &&
-            FD->getODRHash() != NonConstDefn->getODRHash()) {
-          if (!isa<CXXMethodDecl>(FD)) {
-            PendingFunctionOdrMergeFailures[FD].push_back(NonConstDefn);
-          } else if (FD->getLexicalParent()->isFileContext() &&
-                     NonConstDefn->getLexicalParent()->isFileContext()) {
-            // Only diagnose out-of-line method definitions.  If they are
-            // in class definitions, then an error will be generated when
-            // processing the class bodies.
-            PendingFunctionOdrMergeFailures[FD].push_back(NonConstDefn);
-          }
+        if (FD->isLateTemplateParsed() || NonConstDefn->isLateTemplateParsed())
+          continue;
+
+        // The body of a definition identical to the one we already have is
+        // never deserialized.
+        if (FD->getODRHash() == NonConstDefn->getODRHash()) {
+          ++NumODRHashMergedDefinitions;
+          continue;
+        }
+
+        if (!isa<CXXMethodDecl>(FD)) {
+          PendingFunctionOdrMergeFailures[FD].push_back(NonConstDefn);
+        } else if (FD->getLexicalParent()->isFileContext() &&
+                   NonConstDefn->getLexicalParent()->isFileContext()) {
+          // Only diagnose out-of-line method definitions.  If they are
+          // in class definitions, then an error will be generated when
+          // processing the class bodies.
+          PendingFunctionOdrMergeFailures[FD].push_back(NonConstDefn);
         }
       }
       continue;
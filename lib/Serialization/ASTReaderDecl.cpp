@@ -30,6 +30,7 @@
 #include "clang/AST/ExternalASTSource.h"
 #include "clang/AST/LambdaCapture.h"
 #include "clang/AST/NestedNameSpecifier.h"
+#include "clang/AST/ODRHash.h"
 #include "clang/AST/Redeclarable.h"
 #include "clang/AST/Stmt.h"
 #include "clang/AST/TemplateBase.h"
@@ -169,7 +170,8 @@ namespace clang {
     void ReadCXXDefinitionData(struct CXXRecordDecl::DefinitionData &Data,
                                const CXXRecordDecl *D);
     void MergeDefinitionData(CXXRecordDecl *D,
-                             struct CXXRecordDecl::DefinitionData &&NewDD);
+                             struct CXXRecordDecl::DefinitionData &&NewDD,
+                             bool NewDDIsTemporary = false);
     void ReadObjCDefinitionData(struct ObjCInterfaceDecl::DefinitionData &Data);
     void MergeDefinitionData(ObjCInterfaceDecl *D,
                              struct ObjCInterfaceDecl::DefinitionData &&NewDD);
@@ -766,8 +768,12 @@ void ASTDeclReader::VisitEnumDecl(EnumDecl *ED) {
       Reader.MergedDeclContexts.insert(std::make_pair(ED, OldDef));
       ED->setCompleteDefinition(false);
       Reader.mergeDefinitionVisibility(OldDef, ED);
-      if (OldDef->getODRHash() != ED->getODRHash())
+      if (OldDef->getODRHash() != ED->getODRHash()) {
         Reader.PendingEnumOdrMergeFailures[OldDef].push_back(ED);
+      } else {
+        Reader.ODRHashMergedDeclContexts.insert(ED);
+        ++Reader.NumODRHashMergedDefinitions;
+      }
     } else {
       OldDef = ED;
     }
@@ -1740,7 +1746,8 @@ void ASTDeclReader::ReadCXXDefinitionData(
 }
 
 void ASTDeclReader::MergeDefinitionData(
-    CXXRecordDecl *D, struct CXXRecordDecl::DefinitionData &&MergeDD) {
+    CXXRecordDecl *D, struct CXXRecordDecl::DefinitionData &&MergeDD,
+    bool MergeDDIsTemporary) {
   assert(D->DefinitionData &&
          "merging class definition into non-definition");
   auto &DD = *D->DefinitionData;
@@ -1854,9 +1861,22 @@ void ASTDeclReader::MergeDefinitionData(
     DetectedOdrViolation = true;
   }
 
-  if (DetectedOdrViolation)
-    Reader.PendingOdrMergeFailures[DD.Definition].push_back(
-        {MergeDD.Definition, &MergeDD});
+  if (!DetectedOdrViolation) {
+    if (DD.Definition != MergeDD.Definition) {
+      Reader.ODRHashMergedDeclContexts.insert(MergeDD.Definition);
+      ++Reader.NumODRHashMergedDefinitions;
+    }
+    return;
+  }
+
+  // The ODR diagnostics need the merged definition data, so it must outlive
+  // the current deserialization step.
+  auto *FailedDD = &MergeDD;
+  if (MergeDDIsTemporary)
+    FailedDD = new (Reader.getContext())
+        struct CXXRecordDecl::DefinitionData(std::move(MergeDD));
+  Reader.PendingOdrMergeFailures[DD.Definition].push_back(
+      {FailedDD->Definition, FailedDD});
 }
 
 void ASTDeclReader::ReadCXXRecordDefinition(CXXRecordDecl *D, bool Update) {
@@ -1866,13 +1886,27 @@ void ASTDeclReader::ReadCXXRecordDefinition(CXXRecordDecl *D, bool Update) {
   // Determine whether this is a lambda closure type, so that we can
   // allocate the appropriate DefinitionData structure.
   bool IsLambda = Record.readInt();
+  CXXRecordDecl *Canon = D->getCanonicalDecl();
+
+  // If we already have a definition for this record, this one is going to be
+  // merged into it, and (unless it turns out to be an ODR violation) will
+  // never be looked at again. Read it into a temporary rather than allocating
+  // it in the ASTContext; this is the common case when many modules contain
+  // the same textual header.
+  if (!IsLambda && Canon->DefinitionData && !Canon->DefinitionData->IsLambda) {
+    struct CXXRecordDecl::DefinitionData MergeDD(D);
+    D->DefinitionData = Canon->DefinitionData;
+    ReadCXXDefinitionData(MergeDD, D);
+    MergeDefinitionData(Canon, std::move(MergeDD), /*NewDDIsTemporary=*/true);
+    return;
+  }
+
   if (IsLambda)
     DD = new (C) CXXRecordDecl::LambdaDefinitionData(D, nullptr, false, false,
                                                      LCD_None);
   else
     DD = new (C) struct CXXRecordDecl::DefinitionData(D);
 
-  CXXRecordDecl *Canon = D->getCanonicalDecl();
   // Set decl definition data before reading it, so that during deserialization
   // when we read CXXRecordDecl, it already has definition data and we don't
   // set fake one.
@@ -3298,8 +3332,15 @@ ASTDeclReader::FindExistingResult ASTDeclReader::findExisting(NamedDecl *D) {
   // same template specialization into the same CXXRecordDecl.
   auto MergedDCIt = Reader.MergedDeclContexts.find(D->getLexicalDeclContext());
   if (MergedDCIt != Reader.MergedDeclContexts.end() &&
-      MergedDCIt->second == D->getDeclContext())
-    Reader.PendingOdrMergeChecks.push_back(D);
+      MergedDCIt->second == D->getDeclContext()) {
+    // If the two definitions have the same ODR hash and the hash covers this
+    // kind of member, the canonical definition is known to contain it too.
+    if (Reader.ODRHashMergedDeclContexts.count(MergedDCIt->first) &&
+        ODRHash::isWhitelistedDecl(D, D->getDeclContext()))
+      ++Reader.NumSkippedOdrMergeChecks;
+    else
+      Reader.PendingOdrMergeChecks.push_back(D);
+  }
 
   return FindExistingResult(Reader, D, /*Existing=*/nullptr,
                             AnonymousDeclNumber, TypedefNameForLinkage);
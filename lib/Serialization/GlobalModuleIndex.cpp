@@ -21,6 +21,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Bitcode/BitstreamReader.h"
 #include "llvm/Bitcode/BitstreamWriter.h"
 #include "llvm/Support/DJB.h"
@@ -33,6 +34,13 @@
 using namespace clang;
 using namespace serialization;
 
+#define DEBUG_TYPE "globalmoduleindex"
+
+STATISTIC(NumModuleFilesReused,
+          "Number of module files reused from the previous global index");
+STATISTIC(NumModuleFilesLoaded,
+          "Number of module files loaded to build the global index");
+
 //----------------------------------------------------------------------------//
 // Shared constants
 //----------------------------------------------------------------------------//
@@ -58,7 +66,7 @@ namespace {
 static const char * const IndexFileName = "modules.idx";
 
 /// The global index file version.
-static const unsigned CurrentVersion = 1;
+static const unsigned CurrentVersion = 2;
 
 //----------------------------------------------------------------------------//
 // Global module index reader.
@@ -189,6 +197,13 @@ GlobalModuleIndex::GlobalModuleIndex(std::unique_ptr<llvm::MemoryBuffer> Buffer,
       Modules[ID].Size = Record[Idx++];
       Modules[ID].ModTime = Record[Idx++];
 
+      // Signature of the module file, or zero if it didn't have one.
+      Modules[ID].Signature = {
+          {{(uint32_t)Record[Idx], (uint32_t)Record[Idx + 1],
+            (uint32_t)Record[Idx + 2], (uint32_t)Record[Idx + 3],
+            (uint32_t)Record[Idx + 4]}}};
+      Idx += 5;
+
       // File name.
       unsigned NameLen = Record[Idx++];
       Modules[ID].FileName.assign(Record.begin() + Idx,
@@ -239,8 +254,12 @@ GlobalModuleIndex::readIndex(StringRef Path) {
   IndexPath += Path;
   llvm::sys::path::append(IndexPath, IndexFileName);
 
+  // The index is never modified in place (a rebuilt index is renamed over the
+  // old one), so it can always be memory mapped; don't force a copy by
+  // requiring a null terminator.
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> BufferOrErr =
-      llvm::MemoryBuffer::getFile(IndexPath.c_str());
+      llvm::MemoryBuffer::getFile(IndexPath.c_str(), /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
   if (!BufferOrErr)
     return std::make_pair(nullptr, EC_NotFound);
   std::unique_ptr<llvm::MemoryBuffer> Buffer = std::move(BufferOrErr.get());
@@ -386,7 +405,9 @@ namespace {
     ImportedModuleFileInfo(off_t Size, time_t ModTime, ASTFileSignature Sig)
         : StoredSize(Size), StoredModTime(ModTime), StoredSignature(Sig) {}
   };
+}
 
+namespace clang {
   /// Builder that generates the global module index file.
   class GlobalModuleIndexBuilder {
     FileManager &FileMgr;
@@ -414,6 +435,22 @@ namespace {
     /// files in which those identifiers are considered interesting.
     InterestingIdentifierMap InterestingIdentifiers;
 
+    /// A previously-written index whose information can be reused for
+    /// module files that have not changed since it was written.
+    const GlobalModuleIndex *PreviousIndex = nullptr;
+
+    /// The module files known to \c PreviousIndex, indexed by their ID in
+    /// that index, or null if the module file has changed since.
+    SmallVector<const FileEntry *, 16> PreviousFiles;
+
+    /// The unchanged module files known to \c PreviousIndex, mapped to
+    /// their ID in that index.
+    llvm::DenseMap<const FileEntry *, unsigned> ReusableModuleFiles;
+
+    /// The interesting identifiers of each module file in \c PreviousIndex,
+    /// indexed by module ID.
+    std::vector<SmallVector<StringRef, 8>> PreviousIdentifiers;
+
     /// Write the block-info block for the global module index file.
     void emitBlockInfoBlock(llvm::BitstreamWriter &Stream);
 
@@ -440,11 +477,25 @@ namespace {
     /// \returns true if an error occurred, false otherwise.
     bool loadModuleFile(const FileEntry *File);
 
+    /// Make the information in the given, previously-written index
+    /// available for reuse by \c reuseModuleFile().
+    ///
+    /// The index must stay alive until all module files have been added to
+    /// the builder.
+    void loadPreviousIndex(const GlobalModuleIndex &Index);
+
+    /// Add the given module file to the builder using the information
+    /// recorded for it in the previous index, if that is still up to date.
+    ///
+    /// \returns true if the module file was added, false if it needs to be
+    /// loaded with \c loadModuleFile().
+    bool reuseModuleFile(const FileEntry *File);
+
     /// Write the index to the given bitstream.
     /// \returns true if an error occurred, false otherwise.
     bool writeIndex(llvm::BitstreamWriter &Stream);
   };
-}
+} // end namespace clang
 
 static void emitBlockID(unsigned ID, const char *Name,
                         llvm::BitstreamWriter &Stream,
@@ -683,6 +734,104 @@ bool GlobalModuleIndexBuilder::loadModuleFile(const FileEntry *File) {
   return false;
 }
 
+void GlobalModuleIndexBuilder::loadPreviousIndex(
+    const GlobalModuleIndex &Index) {
+  PreviousIndex = &Index;
+
+  // Without the identifier index we cannot tell which identifiers the module
+  // files provide, so none of them can be reused.
+  if (!Index.IdentifierIndex)
+    return;
+
+  // Find the module files that have not changed since the index was written.
+  unsigned NumModules = Index.Modules.size();
+  PreviousFiles.assign(NumModules, nullptr);
+  for (unsigned I = 0; I != NumModules; ++I) {
+    const GlobalModuleIndex::ModuleInfo &Info = Index.Modules[I];
+    if (Info.FileName.empty())
+      continue;
+
+    const FileEntry *File = FileMgr.getFile(Info.FileName, /*openFile=*/false,
+                                            /*cacheFailure=*/false);
+    if (File && File->getSize() == Info.Size &&
+        File->getModificationTime() == Info.ModTime)
+      PreviousFiles[I] = File;
+  }
+
+  // A module file can only be reused if all of the module files it depends on
+  // can be reused too. Otherwise it has to be reloaded, so that its imports
+  // are validated against the current state of its dependencies.
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (unsigned I = 0; I != NumModules; ++I) {
+      if (!PreviousFiles[I])
+        continue;
+
+      for (unsigned Dep : Index.Modules[I].Dependencies) {
+        if (Dep >= NumModules || !PreviousFiles[Dep]) {
+          PreviousFiles[I] = nullptr;
+          Changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  for (unsigned I = 0; I != NumModules; ++I) {
+    if (PreviousFiles[I])
+      ReusableModuleFiles[PreviousFiles[I]] = I;
+  }
+
+  if (ReusableModuleFiles.empty())
+    return;
+
+  // Invert the identifier index, so we know which identifiers each module
+  // file provides. Keys and data are visited in the same order.
+  //
+  // The index also records the identifiers that no module file considers
+  // interesting, so that looking them up never loads a module file. It does
+  // not record which module files they came from, so keep all of them.
+  IdentifierIndexTable &Table =
+      *static_cast<IdentifierIndexTable *>(Index.IdentifierIndex);
+  PreviousIdentifiers.resize(NumModules);
+  IdentifierIndexTable::key_iterator Key = Table.key_begin();
+  for (IdentifierIndexTable::data_iterator D = Table.data_begin(),
+                                           DEnd = Table.data_end();
+       D != DEnd; ++D, ++Key) {
+    (void)InterestingIdentifiers[*Key];
+    SmallVector<unsigned, 2> ModuleIDs = *D;
+    for (unsigned ID : ModuleIDs) {
+      if (ID < NumModules && PreviousFiles[ID])
+        PreviousIdentifiers[ID].push_back(*Key);
+    }
+  }
+}
+
+bool GlobalModuleIndexBuilder::reuseModuleFile(const FileEntry *File) {
+  llvm::DenseMap<const FileEntry *, unsigned>::iterator Known =
+      ReusableModuleFiles.find(File);
+  if (Known == ReusableModuleFiles.end())
+    return false;
+
+  const GlobalModuleIndex::ModuleInfo &Info =
+      PreviousIndex->Modules[Known->second];
+  unsigned ID = getModuleFileInfo(File).ID;
+  getModuleFileInfo(File).Signature = Info.Signature;
+
+  for (unsigned Dep : Info.Dependencies) {
+    unsigned DependsOnID = getModuleFileInfo(PreviousFiles[Dep]).ID;
+    getModuleFileInfo(File).Dependencies.push_back(DependsOnID);
+  }
+
+  if (Known->second < PreviousIdentifiers.size()) {
+    for (StringRef Ident : PreviousIdentifiers[Known->second])
+      InterestingIdentifiers[Ident].push_back(ID);
+  }
+
+  return true;
+}
+
 namespace {
 
 /// Trait used to generate the identifier index as an on-disk hash
@@ -767,6 +916,9 @@ bool GlobalModuleIndexBuilder::writeIndex(llvm::BitstreamWriter &Stream) {
     Record.push_back(M->first->getSize());
     Record.push_back(M->first->getModificationTime());
 
+    // Signature
+    Record.append(M->second.Signature.begin(), M->second.Signature.end());
+
     // File name
     StringRef Name(M->first->getName());
     Record.push_back(Name.size());
@@ -845,6 +997,13 @@ GlobalModuleIndex::writeIndex(FileManager &FileMgr,
   // The module index builder.
   GlobalModuleIndexBuilder Builder(FileMgr, PCHContainerRdr);
 
+  // If there is an existing index, reuse what it knows about module files
+  // that have not changed, so that only new or updated module files need to
+  // be read.
+  std::unique_ptr<GlobalModuleIndex> PreviousIndex(readIndex(Path).first);
+  if (PreviousIndex)
+    Builder.loadPreviousIndex(*PreviousIndex);
+
   // Load each of the module files.
   std::error_code EC;
   for (llvm::sys::fs::directory_iterator D(Path, EC), DEnd;
@@ -866,11 +1025,20 @@ GlobalModuleIndex::writeIndex(FileManager &FileMgr,
     if (!ModuleFile)
       continue;
 
-    // Load this module file.
+    // Load this module file, unless the previous index already knows it.
+    if (Builder.reuseModuleFile(ModuleFile)) {
+      ++NumModuleFilesReused;
+      continue;
+    }
+    ++NumModuleFilesLoaded;
     if (Builder.loadModuleFile(ModuleFile))
       return EC_IOError;
   }
 
+  // Unmap the previous index before replacing it; some systems cannot
+  // rename over a file that is still mapped.
+  PreviousIndex.reset();
+
   // The output buffer, into which the global index will be written.
   SmallVector<char, 16> OutputBuffer;
   {
@@ -897,10 +1065,9 @@ GlobalModuleIndex::writeIndex(FileManager &FileMgr,
   if (Out.has_error())
     return EC_IOError;
 
-  // Remove the old index file. It isn't relevant any more.
-  llvm::sys::fs::remove(IndexPath);
-
-  // Rename the newly-written index file to the proper name.
+  // Rename the newly-written index file to the proper name. This replaces any
+  // old index atomically: readers that have already mapped the old index keep
+  // using it, and new readers never observe a missing or partial index.
   if (llvm::sys::fs::rename(IndexTmpPath, IndexPath)) {
     // Rename failed; just remove the
     llvm::sys::fs::remove(IndexTmpPath);
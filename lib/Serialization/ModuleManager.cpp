@@ -16,6 +16,7 @@
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/MemoryBufferCache.h"
+#include "clang/Basic/SharedModuleCache.h"
 #include "clang/Basic/VirtualFileSystem.h"
 #include "clang/Frontend/PCHContainerOperations.h"
 #include "clang/Lex/HeaderSearch.h"
@@ -74,6 +75,27 @@ ModuleManager::lookupBuffer(StringRef Name) {
   return std::move(InMemoryBuffers[Entry]);
 }
 
+/// Look for a buffer for \p MF that another compilation sharing the
+/// process-wide cache of \p PCMCache has already read.
+static std::shared_ptr<llvm::MemoryBuffer>
+lookupSharedBuffer(MemoryBufferCache &PCMCache, ModuleFile &MF) {
+  SharedModuleCache *Shared = PCMCache.getSharedCache();
+  if (!Shared || !MF.File)
+    return nullptr;
+
+  time_t ValidationTime;
+  std::shared_ptr<llvm::MemoryBuffer> Buffer =
+      Shared->lookupBuffer(MF.FileName, MF.File->getSize(),
+                           MF.File->getModificationTime(), &ValidationTime);
+
+  // If the other compilation found the inputs of the module file to be up to
+  // date, treat that like a validation timestamp in the module cache.
+  if (Buffer && MF.Kind == MK_ImplicitModule &&
+      ValidationTime > MF.InputFilesValidationTimestamp)
+    MF.InputFilesValidationTimestamp = ValidationTime;
+  return Buffer;
+}
+
 static bool checkSignature(ASTFileSignature Signature,
                            ASTFileSignature ExpectedSignature,
                            std::string &ErrorStr) {
@@ -163,6 +185,10 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
     NewModule->Buffer = &PCMCache->addBuffer(FileName, std::move(Buffer));
   } else if (llvm::MemoryBuffer *Buffer = PCMCache->lookupBuffer(FileName)) {
     NewModule->Buffer = Buffer;
+  } else if (std::shared_ptr<llvm::MemoryBuffer> Buffer =
+                 lookupSharedBuffer(*PCMCache, *NewModule)) {
+    // Another compilation in this process already read the module file.
+    NewModule->Buffer = &PCMCache->addBuffer(FileName, std::move(Buffer));
   } else {
     // Open the AST file.
     llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buf((std::error_code()));
@@ -183,7 +209,12 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
       return Missing;
     }
 
-    NewModule->Buffer = &PCMCache->addBuffer(FileName, std::move(*Buf));
+    std::shared_ptr<llvm::MemoryBuffer> Buffer = std::move(*Buf);
+    if (SharedModuleCache *Shared = PCMCache->getSharedCache())
+      if (NewModule->File)
+        Shared->addBuffer(FileName, NewModule->File->getSize(),
+                          NewModule->File->getModificationTime(), Buffer);
+    NewModule->Buffer = &PCMCache->addBuffer(FileName, std::move(Buffer));
   }
 
   // Initialize the stream.
@@ -30,8 +30,26 @@ STATISTIC(NumBlocks,
           "The # of blocks in top level functions");
 STATISTIC(NumBlocksUnreachable,
           "The # of unreachable blocks in analyzing top level functions");
+STATISTIC(NumNodesReclaimed,
+          "The # of exploded graph nodes reclaimed in top level functions");
+STATISTIC(NumDistinctStates,
+          "The # of distinct program states in top level function graphs");
+STATISTIC(MaxStoreBindings,
+          "The maximum # of store bindings in a single program state");
 
 namespace {
+/// Counts the bindings of a store.
+class BindingCounter : public StoreManager::BindingsHandler {
+public:
+  unsigned Count = 0;
+
+  bool HandleBinding(StoreManager &SMgr, Store St, const MemRegion *R,
+                     SVal V) override {
+    ++Count;
+    return true;
+  }
+};
+
 class AnalyzerStatsChecker : public Checker<check::EndAnalysis> {
 public:
   void checkEndAnalysis(ExplodedGraph &G, BugReporter &B,ExprEngine &Eng) const;
@@ -44,6 +62,7 @@ void AnalyzerStatsChecker::checkEndAnalysis(ExplodedGraph &G,
   const CFG *C = nullptr;
   const SourceManager &SM = B.getSourceManager();
   llvm::SmallPtrSet<const CFGBlock*, 32> reachable;
+  llvm::SmallPtrSet<const ProgramState *, 32> states;
 
   // Root node should have the location context of the top most function.
   const ExplodedNode *GraphRoot = *G.roots_begin();
@@ -55,6 +74,7 @@ void AnalyzerStatsChecker::checkEndAnalysis(ExplodedGraph &G,
   for (ExplodedGraph::node_iterator I = G.nodes_begin();
       I != G.nodes_end(); ++I) {
     const ProgramPoint &P = I->getLocation();
+    states.insert(I->getState().get());
 
     // Only check the coverage in the top level function (optimization).
     if (D != P.getLocationContext()->getDecl())
@@ -81,6 +101,20 @@ void AnalyzerStatsChecker::checkEndAnalysis(ExplodedGraph &G,
     }
   }
 
+  // Measure the largest store and environment among the states, so that the
+  // memory used by different store implementations can be compared.
+  unsigned maxStoreBindings = 0, maxEnvBindings = 0;
+  ProgramStateManager &StateMgr = Eng.getStateManager();
+  for (const ProgramState *St : states) {
+    BindingCounter Counter;
+    StateMgr.getStoreManager().iterBindings(St->getStore(), Counter);
+    maxStoreBindings = std::max(maxStoreBindings, Counter.Count);
+
+    const Environment &Env = St->getEnvironment();
+    unsigned envBindings = std::distance(Env.begin(), Env.end());
+    maxEnvBindings = std::max(maxEnvBindings, envBindings);
+  }
+
   // We never 'reach' the entry block, so correct the unreachable count
   unreachable--;
   // There is no BlockEntrance corresponding to the exit block as well, so
@@ -104,13 +138,23 @@ void AnalyzerStatsChecker::checkEndAnalysis(ExplodedGraph &G,
 
   NumBlocksUnreachable += unreachable;
   NumBlocks += total;
+  NumNodesReclaimed += G.getNumReclaimedNodes();
+  NumDistinctStates += states.size();
+  MaxStoreBindings.updateMax(maxStoreBindings);
   std::string NameOfRootFunction = output.str();
 
   output << " -> Total CFGBlocks: " << total << " | Unreachable CFGBlocks: "
       << unreachable << " | Exhausted Block: "
       << (Eng.wasBlocksExhausted() ? "yes" : "no")
       << " | Empty WorkList: "
-      << (Eng.hasEmptyWorkList() ? "yes" : "no");
+      << (Eng.hasEmptyWorkList() ? "yes" : "no")
+      << " | Graph Nodes: " << G.size()
+      << " | Reclaimed Nodes: " << G.getNumReclaimedNodes()
+      << " | Reclaimed Tagged Nodes: " << G.getNumReclaimedTaggedNodes()
+      << " | Graph Memory: " << G.getAllocator().getTotalMemory() << " bytes"
+      << " | States: " << states.size()
+      << " | Max Store Bindings: " << maxStoreBindings
+      << " | Max Environment Bindings: " << maxEnvBindings;
 
   B.EmitBasicReport(D, this, "Analyzer Statistics", "Internal Statistics",
                     output.str(), PathDiagnosticLocation(D, SM));
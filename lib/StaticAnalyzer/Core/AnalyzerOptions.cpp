@@ -21,6 +21,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <utility>
@@ -388,6 +389,11 @@ unsigned AnalyzerOptions::getGraphTrimInterval() {
   return GraphTrimInterval.getValue();
 }
 
+bool AnalyzerOptions::shouldTrimGraphAggressively() {
+  return getBooleanOption(AggressiveGraphTrim, "aggressive-graph-trim",
+                          /* Default = */ false);
+}
+
 unsigned AnalyzerOptions::getMaxSymbolComplexity() {
   if (!MaxSymbolComplexity.hasValue())
     MaxSymbolComplexity = getOptionAsInteger("max-symbol-complexity", 35);
@@ -426,6 +432,32 @@ unsigned AnalyzerOptions::getMaxNodesPerTopLevelFunction() {
   return MaxNodesPerTopLevelFunction.getValue();
 }
 
+unsigned AnalyzerOptions::getMaxTimePerTopLevelFunction() {
+  if (!MaxTimePerTopLevelFunction.hasValue())
+    MaxTimePerTopLevelFunction =
+        getOptionAsInteger("max-time-per-function", 0);
+  return MaxTimePerTopLevelFunction.getValue();
+}
+
+unsigned AnalyzerOptions::getMaxMemoryPerTopLevelFunction() {
+  if (!MaxMemoryPerTopLevelFunction.hasValue())
+    MaxMemoryPerTopLevelFunction =
+        getOptionAsInteger("max-memory-per-function", 0);
+  return MaxMemoryPerTopLevelFunction.getValue();
+}
+
+StringRef AnalyzerOptions::getFunctionTimingOutput() {
+  if (!FunctionTimingOutput.hasValue())
+    FunctionTimingOutput = getOptionAsString("function-timing-output", "");
+  return FunctionTimingOutput.getValue();
+}
+
+StringRef AnalyzerOptions::getResultCacheDir() {
+  if (!ResultCacheDir.hasValue())
+    ResultCacheDir = getOptionAsString("result-cache-dir", "");
+  return ResultCacheDir.getValue();
+}
+
 bool AnalyzerOptions::shouldSynthesizeBodies() {
   return getBooleanOption("faux-bodies", true);
 }
@@ -450,6 +482,12 @@ bool AnalyzerOptions::shouldWidenLoops() {
   return WidenLoops.getValue();
 }
 
+bool AnalyzerOptions::shouldMergeStates() {
+  if (!MergeStates.hasValue())
+    MergeStates = getBooleanOption("state-merging", /*Default=*/false);
+  return MergeStates.getValue();
+}
+
 bool AnalyzerOptions::shouldUnrollLoops() {
   if (!UnrollLoops.hasValue())
     UnrollLoops = getBooleanOption("unroll-loops", /*Default=*/false);
@@ -493,3 +531,30 @@ StringRef AnalyzerOptions::getCTUIndexName() {
     CTUIndexName = getOptionAsString("ctu-index-name", "externalFnMap.txt");
   return CTUIndexName.getValue();
 }
+
+unsigned AnalyzerOptions::getCTUASTMemoryBudget() {
+  if (!CTUASTMemoryBudget.hasValue())
+    CTUASTMemoryBudget = getOptionAsInteger("ctu-ast-memory-budget", 0);
+  return CTUASTMemoryBudget.getValue();
+}
+
+unsigned AnalyzerOptions::getAnalysisShardCount() {
+  if (!AnalysisShardCount.hasValue())
+    AnalysisShardCount = std::max(getOptionAsInteger("shard-count", 1), 1);
+  return AnalysisShardCount.getValue();
+}
+
+unsigned AnalyzerOptions::getAnalysisShardIndex() {
+  if (!AnalysisShardIndex.hasValue()) {
+    int Index = getOptionAsInteger("shard-index", 0);
+    ValidAnalysisShardIndex =
+        Index >= 0 && unsigned(Index) < getAnalysisShardCount();
+    AnalysisShardIndex = ValidAnalysisShardIndex ? Index : 0;
+  }
+  return AnalysisShardIndex.getValue();
+}
+
+bool AnalyzerOptions::hasValidAnalysisShardIndex() {
+  getAnalysisShardIndex();
+  return ValidAnalysisShardIndex;
+}
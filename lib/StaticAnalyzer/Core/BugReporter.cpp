@@ -80,6 +80,9 @@ STATISTIC(MaxBugClassSize,
 STATISTIC(MaxValidBugClassSize,
           "The maximum number of bug reports in the same equivalence class "
           "where at least one report is valid (not suppressed)");
+STATISTIC(NumTrimmedFromReportsGraph,
+          "The # of equivalence classes whose paths were found in the graph "
+          "shared by all the reports of a function");
 
 BugReporterVisitor::~BugReporterVisitor() = default;
 
@@ -2318,8 +2321,11 @@ class TrimmedGraph {
   };
 
 public:
+  /// \param SourceInverseMap If \p OriginalGraph is itself a trimmed graph,
+  /// the map from its nodes to the nodes of the graph it was trimmed from.
   TrimmedGraph(const ExplodedGraph *OriginalGraph,
-               ArrayRef<const ExplodedNode *> Nodes);
+               ArrayRef<const ExplodedNode *> Nodes,
+               const InterExplodedGraphMap *SourceInverseMap = nullptr);
 
   bool popNextReportGraph(ReportGraph &GraphWrapper);
 };
@@ -2327,11 +2333,15 @@ public:
 } // namespace
 
 TrimmedGraph::TrimmedGraph(const ExplodedGraph *OriginalGraph,
-                           ArrayRef<const ExplodedNode *> Nodes) {
+                           ArrayRef<const ExplodedNode *> Nodes,
+                           const InterExplodedGraphMap *SourceInverseMap) {
   // The trimmed graph is created in the body of the constructor to ensure
   // that the DenseMaps have been initialized already.
   InterExplodedGraphMap ForwardMap;
   G = OriginalGraph->trim(Nodes, &ForwardMap, &InverseMap);
+  if (SourceInverseMap)
+    for (auto &I : InverseMap)
+      I.second = SourceInverseMap->lookup(I.second);
 
   // Find the (first) error node in the trimmed graph.  We just need to consult
   // the node map which maps from nodes in the original graph to nodes
@@ -2662,9 +2672,33 @@ GRBugReporter::generatePathDiagnostics(
   if (!HasValid)
     return Out;
 
-  TrimmedGraph TrimG(&getGraph(), errorNodes);
+  // Find the paths in the graph shared by all the reports if possible, as it
+  // is usually much smaller than the exploded graph. The result is the same,
+  // since that graph keeps the order of the successors.
+  buildReportsGraph();
+  SmallVector<const ExplodedNode *, 32> ReportsGraphNodes;
+  if (ReportsGraph) {
+    for (const ExplodedNode *N : errorNodes) {
+      const ExplodedNode *NewN = N ? ReportsGraphForwardMap.lookup(N) : nullptr;
+      // Reports emitted after the graph was built are not in it.
+      if (N && !NewN) {
+        ReportsGraphNodes.clear();
+        break;
+      }
+      ReportsGraphNodes.push_back(NewN);
+    }
+  }
+
+  std::unique_ptr<TrimmedGraph> TrimG;
+  if (!ReportsGraphNodes.empty()) {
+    ++NumTrimmedFromReportsGraph;
+    TrimG = llvm::make_unique<TrimmedGraph>(
+        ReportsGraph.get(), ReportsGraphNodes, &ReportsGraphInverseMap);
+  } else {
+    TrimG = llvm::make_unique<TrimmedGraph>(&getGraph(), errorNodes);
+  }
   ReportGraph ErrorGraph;
-  auto ReportInfo = findValidReport(TrimG, ErrorGraph, bugReports,
+  auto ReportInfo = findValidReport(*TrimG, ErrorGraph, bugReports,
                   getAnalyzerOptions(), *this);
   BugReport *R = ReportInfo.first;
 
@@ -2681,6 +2715,29 @@ GRBugReporter::generatePathDiagnostics(
   return Out;
 }
 
+void GRBugReporter::buildReportsGraph() {
+  if (ReportsGraphBuilt)
+    return;
+  ReportsGraphBuilt = true;
+
+  SmallVector<const ExplodedNode *, 32> ErrorNodes;
+  unsigned NumClasses = 0;
+  for (EQClasses_iterator EQ = EQClasses_begin(), E = EQClasses_end(); EQ != E;
+       ++EQ) {
+    ++NumClasses;
+    for (BugReport &R : *EQ)
+      if (const ExplodedNode *N = R.getErrorNode())
+        ErrorNodes.push_back(N);
+  }
+
+  // A single class gains nothing from the shared graph.
+  if (NumClasses < 2 || ErrorNodes.empty())
+    return;
+
+  ReportsGraph = getGraph().trimPreservingOrder(
+      ErrorNodes, &ReportsGraphForwardMap, &ReportsGraphInverseMap);
+}
+
 void BugReporter::Register(BugType *BT) {
   BugTypes = F.add(BugTypes, BT);
 }
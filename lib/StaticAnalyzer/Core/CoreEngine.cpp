@@ -34,6 +34,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -46,6 +47,10 @@ STATISTIC(NumSteps,
             "The # of steps executed.");
 STATISTIC(NumReachedMaxSteps,
             "The # of times we reached the max number of steps.");
+STATISTIC(NumReachedTimeBudget,
+            "The # of times we ran out of time analyzing a function.");
+STATISTIC(NumReachedMemoryBudget,
+            "The # of times we ran out of memory analyzing a function.");
 STATISTIC(NumPathsExplored,
             "The # of paths explored by the analyzer.");
 
@@ -73,7 +78,9 @@ static std::unique_ptr<WorkList> generateWorkList(AnalyzerOptions &Opts) {
 CoreEngine::CoreEngine(SubEngine &subengine, FunctionSummariesTy *FS,
                        AnalyzerOptions &Opts)
     : SubEng(subengine), WList(generateWorkList(Opts)),
-      BCounterFactory(G.getAllocator()), FunctionSummaries(FS) {}
+      BCounterFactory(G.getAllocator()), FunctionSummaries(FS),
+      TimeBudget(Opts.getMaxTimePerTopLevelFunction()),
+      MemoryBudget(uint64_t(Opts.getMaxMemoryPerTopLevelFunction()) << 20) {}
 
 /// ExecuteWorkList - Run the worklist algorithm for a maximum number of steps.
 bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
@@ -125,15 +132,37 @@ bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
   if(!UnlimitedSteps)
     G.reserve(std::min(Steps,PreReservationCap));
 
+  // Checking the budgets after every step would be too expensive.
+  const unsigned BudgetCheckInterval = 256;
+  unsigned StepsUntilBudgetCheck = BudgetCheckInterval;
+  auto Deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(TimeBudget);
+
+  LastStopReason = StopReason::WorkListEmpty;
   while (WList->hasWork()) {
     if (!UnlimitedSteps) {
       if (Steps == 0) {
         NumReachedMaxSteps++;
+        LastStopReason = StopReason::MaxSteps;
         break;
       }
       --Steps;
     }
 
+    if ((TimeBudget || MemoryBudget) && --StepsUntilBudgetCheck == 0) {
+      StepsUntilBudgetCheck = BudgetCheckInterval;
+      if (TimeBudget && std::chrono::steady_clock::now() > Deadline) {
+        NumReachedTimeBudget++;
+        LastStopReason = StopReason::TimeBudget;
+        break;
+      }
+      if (MemoryBudget && G.getAllocator().getTotalMemory() > MemoryBudget) {
+        NumReachedMemoryBudget++;
+        LastStopReason = StopReason::MemoryBudget;
+        break;
+      }
+    }
+
     NumSteps++;
 
     const WorkListUnit& WU = WList->dequeue();
@@ -92,7 +92,8 @@ bool ExplodedGraph::shouldCollect(const ExplodedNode *node) {
   // apply:
   //
   // (3) The ProgramPoint is for a PostStmt, but not a PostStore.
-  // (4) There is no 'tag' for the ProgramPoint.
+  // (4) There is no 'tag' for the ProgramPoint, or the tag was registered
+  //     with addReclaimableTag().
   // (5) The 'store' is the same as the predecessor.
   // (6) The 'GDM' is the same as the predecessor.
   // (7) The LocationContext is the same as the predecessor.
@@ -119,14 +120,14 @@ bool ExplodedGraph::shouldCollect(const ExplodedNode *node) {
   // analysis history and are not consulted by any client code.
   ProgramPoint progPoint = node->getLocation();
   if (progPoint.getAs<PreStmtPurgeDeadSymbols>())
-    return !progPoint.getTag();
+    return isReclaimableTag(progPoint.getTag());
 
   // Condition 3.
   if (!progPoint.getAs<PostStmt>() || progPoint.getAs<PostStore>())
     return false;
 
   // Condition 4.
-  if (progPoint.getTag())
+  if (!isReclaimableTag(progPoint.getTag()))
     return false;
 
   // Conditions 5, 6, and 7.
@@ -182,6 +183,10 @@ void ExplodedGraph::collectNode(ExplodedNode *node) {
   FreeNodes.push_back(node);
   Nodes.RemoveNode(node);
   --NumNodes;
+  ++NumReclaimedNodes;
+  // Nodes with other tags are never collected.
+  if (node->getLocation().getTag())
+    ++NumReclaimedTaggedNodes;
   node->~ExplodedNode();
 }
 
@@ -211,6 +216,8 @@ void ExplodedGraph::reclaimRecentlyAllocatedNodes() {
 // it can be either a pointer to a single ExplodedNode, or a pointer to a
 // BumpVector allocated with the ExplodedGraph's allocator. This allows the
 // common case of single-node NodeGroups to be implemented with no extra memory.
+// Groups with more than one node mostly come from two-way branches and joins,
+// so the vector starts out with room for just two nodes.
 //
 // Consequently, each of the NodeGroup methods have up to four cases to handle:
 // 1. The flag is set and this group does not actually contain any nodes.
@@ -256,7 +263,7 @@ void ExplodedNode::NodeGroup::addNode(ExplodedNode *N, ExplodedGraph &G) {
 
     BumpVectorContext &Ctx = G.getNodeAllocator();
     V = G.getAllocator().Allocate<ExplodedNodeVector>();
-    new (V) ExplodedNodeVector(Ctx, 4);
+    new (V) ExplodedNodeVector(Ctx, 2);
     V->push_back(Old, Ctx);
 
     Storage = V;
@@ -353,7 +360,8 @@ std::unique_ptr<ExplodedGraph>
 ExplodedGraph::trim(ArrayRef<const NodeTy *> Sinks,
                     InterExplodedGraphMap *ForwardMap,
                     InterExplodedGraphMap *InverseMap) const {
-  if (Nodes.empty())
+  // Trimmed graphs only consist of uncached nodes, so check the roots too.
+  if (Nodes.empty() && Roots.empty())
     return nullptr;
 
   using Pass1Ty = llvm::DenseSet<const ExplodedNode *>;
@@ -449,3 +457,82 @@ ExplodedGraph::trim(ArrayRef<const NodeTy *> Sinks,
 
   return G;
 }
+
+std::unique_ptr<ExplodedGraph>
+ExplodedGraph::trimPreservingOrder(ArrayRef<const NodeTy *> Sinks,
+                                   InterExplodedGraphMap *ForwardMap,
+                                   InterExplodedGraphMap *InverseMap) const {
+  if (Nodes.empty())
+    return nullptr;
+
+  // Find all the nodes on paths leading to the sinks.
+  llvm::DenseSet<const ExplodedNode *> Reached;
+  SmallVector<const ExplodedNode *, 32> Order;
+  SmallVector<const ExplodedNode *, 10> WL;
+  bool HasRoot = false;
+  for (const auto Sink : Sinks)
+    if (Sink)
+      WL.push_back(Sink);
+  while (!WL.empty()) {
+    const ExplodedNode *N = WL.pop_back_val();
+    if (!Reached.insert(N).second)
+      continue;
+    Order.push_back(N);
+    if (N->Preds.empty())
+      HasRoot = true;
+    WL.append(N->Preds.begin(), N->Preds.end());
+  }
+
+  if (!HasRoot)
+    return nullptr;
+
+  std::unique_ptr<ExplodedGraph> G = MakeEmptyGraph();
+  NodeMap Map;
+
+  // Create all the nodes first, so that the edges can then be added in an
+  // order that keeps both the predecessors and the successors of each node in
+  // their order in this graph.
+  for (const ExplodedNode *N : Order) {
+    ExplodedNode *NewN =
+        G->createUncachedNode(N->getLocation(), N->State, N->isSink());
+    Map[N] = NewN;
+    if (ForwardMap)
+      (*ForwardMap)[N] = NewN;
+    if (InverseMap)
+      (*InverseMap)[NewN] = N;
+    if (N->Preds.empty())
+      G->addRoot(NewN);
+  }
+
+  // Every edge was appended to the predecessors of its target and to the
+  // successors of its source at the same time, so such an order exists: add
+  // an edge once it is next in line in both lists. All the predecessors of
+  // the nodes were reached, but some of their successors were not.
+  llvm::DenseMap<const ExplodedNode *, unsigned> NextPred, NextSucc;
+  SmallVector<const ExplodedNode *, 32> Ready(Order.begin(), Order.end());
+  while (!Ready.empty()) {
+    const ExplodedNode *N = Ready.pop_back_val();
+    while (true) {
+      unsigned SuccIdx = NextSucc[N];
+      while (SuccIdx != N->succ_size() && !Map.count(N->succ_begin()[SuccIdx]))
+        ++SuccIdx;
+      NextSucc[N] = SuccIdx;
+      if (SuccIdx == N->succ_size())
+        break;
+
+      const ExplodedNode *Succ = N->succ_begin()[SuccIdx];
+      unsigned PredIdx = NextPred[Succ];
+      if (Succ->pred_begin()[PredIdx] != N)
+        break;
+
+      Map[Succ]->addPredecessor(Map[N], *G);
+      NextSucc[N] = SuccIdx + 1;
+      NextPred[Succ] = ++PredIdx;
+      // The next predecessor of the successor may have been waiting for it.
+      if (PredIdx != Succ->pred_size())
+        Ready.push_back(Succ->pred_begin()[PredIdx]);
+    }
+  }
+
+  return G;
+}
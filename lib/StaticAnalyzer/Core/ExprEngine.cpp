@@ -97,6 +97,10 @@ STATISTIC(NumMaxBlockCountReachedInInlined,
             "an inlined function");
 STATISTIC(NumTimesRetriedWithoutInlining,
             "The # of times we re-evaluated a call without inlining");
+STATISTIC(NumJoinedStates,
+            "The # of states created by joining paths at a CFG join point");
+STATISTIC(NumPathsMerged,
+            "The # of paths merged into another path at a CFG join point");
 
 
 //===----------------------------------------------------------------------===//
@@ -176,6 +180,12 @@ REGISTER_TRAIT_WITH_PROGRAMSTATE(ObjectsUnderConstruction,
 
 static const char* TagProviderName = "ExprEngine";
 
+/// A tag to track convenience transitions, which can be removed at cleanup.
+static const ProgramPointTag *getCleanupNodeTag() {
+  static SimpleProgramPointTag cleanupTag(TagProviderName, "Clean Node");
+  return &cleanupTag;
+}
+
 ExprEngine::ExprEngine(cross_tu::CrossTranslationUnitContext &CTU,
                        AnalysisManager &mgr, bool gcEnabled,
                        SetOfConstDecls *VisitedCalleesIn,
@@ -195,6 +205,8 @@ ExprEngine::ExprEngine(cross_tu::CrossTranslationUnitContext &CTU,
   if (TrimInterval != 0) {
     // Enable eager node reclaimation when constructing the ExplodedGraph.
     G.enableNodeReclamation(TrimInterval);
+    if (mgr.options.shouldTrimGraphAggressively())
+      G.addReclaimableTag(getCleanupNodeTag());
   }
 }
 
@@ -664,14 +676,13 @@ void ExprEngine::removeDead(ExplodedNode *Pred, ExplodedNodeSet &Out,
   CleanedState = StateMgr.removeDeadBindings(CleanedState, SFC, SymReaper);
 
   // Process any special transfer function for dead symbols.
-  // A tag to track convenience transitions, which can be removed at cleanup.
-  static SimpleProgramPointTag cleanupTag(TagProviderName, "Clean Node");
   if (!SymReaper.hasDeadSymbols()) {
     // Generate a CleanedNode that has the environment and store cleaned
     // up. Since no symbols are dead, we can optimize and not clean out
     // the constraint manager.
     StmtNodeBuilder Bldr(Pred, Out, *currBldrCtx);
-    Bldr.generateNode(DiagnosticStmt, Pred, CleanedState, &cleanupTag, K);
+    Bldr.generateNode(DiagnosticStmt, Pred, CleanedState, getCleanupNodeTag(),
+                      K);
 
   } else {
     // Call checkers with the non-cleaned state so that they could query the
@@ -702,7 +713,8 @@ void ExprEngine::removeDead(ExplodedNode *Pred, ExplodedNodeSet &Out,
       // generate a transition to that state.
       ProgramStateRef CleanedCheckerSt =
         StateMgr.getPersistentStateWithGDM(CleanedState, CheckerState);
-      Bldr.generateNode(DiagnosticStmt, I, CleanedCheckerSt, &cleanupTag, K);
+      Bldr.generateNode(DiagnosticStmt, I, CleanedCheckerSt,
+                        getCleanupNodeTag(), K);
     }
   }
 }
@@ -1910,7 +1922,49 @@ void ExprEngine::processCFGBlockEntrance(const BlockEdge &L,
 
     // Make sink nodes as exhausted(for stats) only if retry failed.
     Engine.blocksExhausted.push_back(std::make_pair(L, Sink));
+    return;
+  }
+
+  joinStatesAtBlockEntrance(nodeBuilder, Pred);
+}
+
+void ExprEngine::joinStatesAtBlockEntrance(NodeBuilderWithSinks &nodeBuilder,
+                                           ExplodedNode *Pred) {
+  if (!AMgr.options.shouldMergeStates())
+    return;
+
+  const CFGBlock *Block = nodeBuilder.getContext().getBlock();
+  if (Block->pred_size() < 2)
+    return;
+
+  // Only paths whose states differ in nothing but the constraints are joined,
+  // so that the joined state is just less constrained than each of them.
+  ProgramStateRef State = Pred->getState();
+  ConstraintManager &CM = getConstraintManager();
+  ProgramStateRef Unconstrained = CM.removeAllConstraints(State);
+  if (!Unconstrained)
+    return;
+
+  JoinPointKey Key({Block, Pred->getLocationContext()}, Unconstrained.get());
+  std::pair<ProgramStateRef, ProgramStateRef> &Entry = JoinedStates[Key];
+  if (!Entry.first) {
+    Entry = std::make_pair(Unconstrained, State);
+    return;
   }
+
+  ProgramStateRef Joined = CM.joinConstraints(Entry.second, State);
+  if (!Joined)
+    return;
+  Entry.second = Joined;
+  if (Joined == State)
+    return;
+
+  // Continue with the joined state instead. If a path already continued
+  // with it, this path ends here.
+  if (nodeBuilder.generateNode(Joined, Pred))
+    ++NumJoinedStates;
+  else
+    ++NumPathsMerged;
 }
 
 //===----------------------------------------------------------------------===//
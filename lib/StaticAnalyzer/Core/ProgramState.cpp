@@ -19,11 +19,22 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/SubEngine.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/TaintManager.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/DynamicTypeMap.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
 using namespace ento;
 
+#define DEBUG_TYPE "ProgramState"
+
+STATISTIC(NumStatesCreated, "The # of distinct program states created");
+STATISTIC(NumStatesUniqued,
+          "The # of program states found in the set of existing states");
+STATISTIC(NumStatesRecycled,
+          "The # of program states allocated in the memory of a freed state");
+STATISTIC(NumUnchangedStores,
+          "The # of store updates that did not change the store");
+
 namespace clang { namespace  ento {
 /// Increments the number of times this state is referenced.
 
@@ -414,11 +425,15 @@ ProgramStateRef ProgramStateManager::getPersistentState(ProgramState &State) {
   State.Profile(ID);
   void *InsertPos;
 
-  if (ProgramState *I = StateSet.FindNodeOrInsertPos(ID, InsertPos))
+  if (ProgramState *I = StateSet.FindNodeOrInsertPos(ID, InsertPos)) {
+    ++NumStatesUniqued;
     return I;
+  }
 
+  ++NumStatesCreated;
   ProgramState *newState = nullptr;
   if (!freeStates.empty()) {
+    ++NumStatesRecycled;
     newState = freeStates.back();
     freeStates.pop_back();
   }
@@ -431,6 +446,13 @@ ProgramStateRef ProgramStateManager::getPersistentState(ProgramState &State) {
 }
 
 ProgramStateRef ProgramState::makeWithStore(const StoreRef &store) const {
+  // The stores are uniqued, so binding a value that is already there gives
+  // back the same store. Skip copying and profiling the state in that case.
+  if (store.getStore() == getStore()) {
+    ++NumUnchangedStores;
+    return this;
+  }
+
   ProgramState NewSt(*this);
   NewSt.setStore(store);
   return getStateManager().getPersistentState(NewSt);
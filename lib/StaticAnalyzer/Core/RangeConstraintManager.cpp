@@ -17,16 +17,46 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramStateTrait.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/RangedConstraintManager.h"
 #include "llvm/ADT/FoldingSet.h"
-#include "llvm/ADT/ImmutableSet.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 
 using namespace clang;
 using namespace ento;
 
-void RangeSet::IntersectInRange(BasicValueFactory &BV, Factory &F,
-                      const llvm::APSInt &Lower, const llvm::APSInt &Upper,
-                      PrimRangeSet &newRanges, PrimRangeSet::iterator &i,
-                      PrimRangeSet::iterator &e) const {
+/// Order ranges by their values rather than by the addresses of the values,
+/// so that the order is deterministic.
+static bool isLess(const Range &LHS, const Range &RHS) {
+  return LHS.From() < RHS.From() ||
+         (!(RHS.From() < LHS.From()) && LHS.To() < RHS.To());
+}
+
+RangeSet RangeSet::Factory::getRangeSet(ContainerType Ranges) {
+  // Most operations produce their ranges in order already.
+  if (!std::is_sorted(Ranges.begin(), Ranges.end(), isLess))
+    std::sort(Ranges.begin(), Ranges.end(), isLess);
+
+  llvm::FoldingSetNodeID ID;
+  Storage::Profile(ID, Ranges);
+  void *InsertPos;
+  Storage *S = Cache.FindNodeOrInsertPos(ID, InsertPos);
+  if (!S) {
+    S = new (Arena.Allocate()) Storage(std::move(Ranges));
+    Cache.InsertNode(S, InsertPos);
+  }
+  return RangeSet(&S->Ranges);
+}
+
+RangeSet RangeSet::addRange(Factory &F, const RangeSet &RS) const {
+  ContainerType NewRanges(RS.begin(), RS.end());
+  NewRanges.append(begin(), end());
+  return F.getRangeSet(std::move(NewRanges));
+}
+
+void RangeSet::IntersectInRange(BasicValueFactory &BV,
+                                const llvm::APSInt &Lower,
+                                const llvm::APSInt &Upper,
+                                ContainerType &NewRanges, iterator &i,
+                                iterator e) const {
   // There are six cases for each range R in the set:
   //   1. R is entirely before the intersection range.
   //   2. R is entirely after the intersection range.
@@ -45,24 +75,23 @@ void RangeSet::IntersectInRange(BasicValueFactory &BV, Factory &F,
 
     if (i->Includes(Lower)) {
       if (i->Includes(Upper)) {
-        newRanges =
-            F.add(newRanges, Range(BV.getValue(Lower), BV.getValue(Upper)));
+        NewRanges.push_back(Range(BV.getValue(Lower), BV.getValue(Upper)));
         break;
       } else
-        newRanges = F.add(newRanges, Range(BV.getValue(Lower), i->To()));
+        NewRanges.push_back(Range(BV.getValue(Lower), i->To()));
     } else {
       if (i->Includes(Upper)) {
-        newRanges = F.add(newRanges, Range(i->From(), BV.getValue(Upper)));
+        NewRanges.push_back(Range(i->From(), BV.getValue(Upper)));
         break;
       } else
-        newRanges = F.add(newRanges, *i);
+        NewRanges.push_back(*i);
     }
   }
 }
 
 const llvm::APSInt &RangeSet::getMinValue() const {
   assert(!isEmpty());
-  return ranges.begin()->From();
+  return begin()->From();
 }
 
 bool RangeSet::pin(llvm::APSInt &Lower, llvm::APSInt &Upper) const {
@@ -158,52 +187,78 @@ RangeSet RangeSet::Intersect(BasicValueFactory &BV, Factory &F,
   if (!pin(Lower, Upper))
     return F.getEmptySet();
 
-  PrimRangeSet newRanges = F.getEmptySet();
+  ContainerType NewRanges;
 
-  PrimRangeSet::iterator i = begin(), e = end();
+  iterator i = begin(), e = end();
   if (Lower <= Upper)
-    IntersectInRange(BV, F, Lower, Upper, newRanges, i, e);
+    IntersectInRange(BV, Lower, Upper, NewRanges, i, e);
   else {
     // The order of the next two statements is important!
     // IntersectInRange() does not reset the iteration state for i and e.
     // Therefore, the lower range most be handled first.
-    IntersectInRange(BV, F, BV.getMinValue(Upper), Upper, newRanges, i, e);
-    IntersectInRange(BV, F, Lower, BV.getMaxValue(Lower), newRanges, i, e);
+    IntersectInRange(BV, BV.getMinValue(Upper), Upper, NewRanges, i, e);
+    IntersectInRange(BV, Lower, BV.getMaxValue(Lower), NewRanges, i, e);
   }
 
-  return newRanges;
+  return F.getRangeSet(std::move(NewRanges));
 }
 
 // Turn all [A, B] ranges to [-B, -A]. Ranges [MIN, B] are turned to range set
 // [MIN, MIN] U [-B, MAX], when MIN and MAX are the minimal and the maximal
 // signed values of the type.
 RangeSet RangeSet::Negate(BasicValueFactory &BV, Factory &F) const {
-  PrimRangeSet newRanges = F.getEmptySet();
+  // The ranges are collected unordered; getRangeSet() sorts them. Only the
+  // first range of this set can start at MIN, so [MIN, MIN] is kept in front
+  // where the range ending at MAX can find it.
+  ContainerType newRanges;
 
   for (iterator i = begin(), e = end(); i != e; ++i) {
     const llvm::APSInt &from = i->From(), &to = i->To();
     const llvm::APSInt &newTo = (from.isMinSignedValue() ?
                                  BV.getMaxValue(from) :
                                  BV.getValue(- from));
-    if (to.isMaxSignedValue() && !newRanges.isEmpty() &&
-        newRanges.begin()->From().isMinSignedValue()) {
-      assert(newRanges.begin()->To().isMinSignedValue() &&
+    if (to.isMaxSignedValue() && !newRanges.empty() &&
+        newRanges.front().From().isMinSignedValue()) {
+      assert(newRanges.front().To().isMinSignedValue() &&
              "Ranges should not overlap");
       assert(!from.isMinSignedValue() && "Ranges should not overlap");
-      const llvm::APSInt &newFrom = newRanges.begin()->From();
-      newRanges =
-        F.add(F.remove(newRanges, *newRanges.begin()), Range(newFrom, newTo));
+      const llvm::APSInt &newFrom = newRanges.front().From();
+      newRanges.front() = Range(newFrom, newTo);
     } else if (!to.isMinSignedValue()) {
       const llvm::APSInt &newFrom = BV.getValue(- to);
-      newRanges = F.add(newRanges, Range(newFrom, newTo));
+      newRanges.push_back(Range(newFrom, newTo));
     }
     if (from.isMinSignedValue()) {
-      newRanges = F.add(newRanges, Range(BV.getMinValue(from),
-                                         BV.getMinValue(from)));
+      newRanges.insert(newRanges.begin(), Range(BV.getMinValue(from),
+                                                BV.getMinValue(from)));
+    }
+  }
+
+  return F.getRangeSet(std::move(newRanges));
+}
+
+RangeSet RangeSet::Union(Factory &F, const RangeSet &Other) const {
+  ContainerType AllRanges(begin(), end());
+  AllRanges.append(Other.begin(), Other.end());
+  std::sort(AllRanges.begin(), AllRanges.end(), isLess);
+
+  // Merge the ranges that overlap or are adjacent.
+  ContainerType NewRanges;
+  for (const Range &R : AllRanges) {
+    if (!NewRanges.empty()) {
+      Range &Last = NewRanges.back();
+      llvm::APSInt AfterLast = Last.To();
+      ++AfterLast;
+      if (R.From() <= Last.To() || R.From() == AfterLast) {
+        if (Last.To() < R.To())
+          Last = Range(Last.From(), R.To());
+        continue;
+      }
     }
+    NewRanges.push_back(R);
   }
 
-  return newRanges;
+  return F.getRangeSet(std::move(NewRanges));
 }
 
 void RangeSet::print(raw_ostream &os) const {
@@ -244,6 +299,11 @@ public:
   void print(ProgramStateRef State, raw_ostream &Out, const char *nl,
              const char *sep) override;
 
+  ProgramStateRef removeAllConstraints(ProgramStateRef State) override;
+
+  ProgramStateRef joinConstraints(ProgramStateRef StA,
+                                  ProgramStateRef StB) override;
+
   //===------------------------------------------------------------------===//
   // Implementation for interface from RangedConstraintManager.
   //===------------------------------------------------------------------===//
@@ -408,6 +468,39 @@ RangeConstraintManager::removeDeadBindings(ProgramStateRef State,
   return Changed ? State->set<ConstraintRange>(CR) : State;
 }
 
+ProgramStateRef
+RangeConstraintManager::removeAllConstraints(ProgramStateRef State) {
+  return State->remove<ConstraintRange>();
+}
+
+ProgramStateRef RangeConstraintManager::joinConstraints(ProgramStateRef StA,
+                                                        ProgramStateRef StB) {
+  ConstraintRangeTy CA = StA->get<ConstraintRange>();
+  ConstraintRangeTy CB = StB->get<ConstraintRange>();
+  ConstraintRangeTy::Factory &CRFactory = StA->get_context<ConstraintRange>();
+  ConstraintRangeTy Joined = CRFactory.getEmptyMap();
+
+  // A symbol constrained in only one of the states is not constrained in the
+  // joined state, and neither is a symbol that may take any value.
+  BasicValueFactory &BV = getBasicVals();
+  for (ConstraintRangeTy::iterator I = CA.begin(), E = CA.end(); I != E; ++I) {
+    const RangeSet *OtherRanges = CB.lookup(I.getKey());
+    if (!OtherRanges)
+      continue;
+    RangeSet Ranges = I.getData().Union(F, *OtherRanges);
+    if (Ranges.begin() + 1 == Ranges.end()) {
+      const Range &R = *Ranges.begin();
+      if (R.From() == BV.getMinValue(R.From()) &&
+          R.To() == BV.getMaxValue(R.To()))
+        continue;
+    }
+    Joined = CRFactory.add(Joined, I.getKey(), Ranges);
+  }
+
+  ProgramStateRef State = removeAllConstraints(StA);
+  return Joined.isEmpty() ? State : State->set<ConstraintRange>(Joined);
+}
+
 /// Return a range set subtracting zero from \p Domain.
 static RangeSet assumeNonZero(
     BasicValueFactory &BV,
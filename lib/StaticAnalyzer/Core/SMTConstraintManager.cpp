@@ -8,13 +8,23 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/StaticAnalyzer/Core/PathSensitive/SMTConstraintManager.h"
+#include "clang/Basic/StatisticTimer.h"
 #include "clang/Basic/TargetInfo.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/ExprEngine.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramState.h"
+#include "llvm/ADT/Statistic.h"
 
 using namespace clang;
 using namespace ento;
 
+#define DEBUG_TYPE "SMTConstraintManager"
+
+STATISTIC(NumSolverQueries, "The # of queries made to the SMT solver");
+STATISTIC(SolverTimeMicroseconds,
+          "The # of microseconds spent in SMT solver queries");
+STATISTIC(MaxSolverQueryMicroseconds,
+          "The maximum # of microseconds spent in a single SMT solver query");
+
 ProgramStateRef SMTConstraintManager::assumeSym(ProgramStateRef State,
                                                 SymbolRef Sym,
                                                 bool Assumption) {
@@ -61,16 +71,17 @@ ConditionTruthVal SMTConstraintManager::checkNull(ProgramStateRef State,
   SMTExprRef NotExp =
       Solver->getZeroExpr(Ctx, VarExp, RetTy, /*Assumption=*/false);
 
-  Solver->reset();
-  addStateConstraints(State);
+  setStateConstraints(State);
 
   Solver->push();
   Solver->addConstraint(Exp);
-  ConditionTruthVal isSat = Solver->check();
-
+  ConditionTruthVal isSat = checkSolver();
   Solver->pop();
+
+  Solver->push();
   Solver->addConstraint(NotExp);
-  ConditionTruthVal isNotSat = Solver->check();
+  ConditionTruthVal isNotSat = checkSolver();
+  Solver->pop();
 
   // Zero is the only possible solution
   if (isSat.isConstrainedTrue() && isNotSat.isConstrainedFalse())
@@ -98,11 +109,10 @@ const llvm::APSInt *SMTConstraintManager::getSymVal(ProgramStateRef State,
     SMTExprRef Exp =
         Solver->fromData(SD->getSymbolID(), Ty, Ctx.getTypeSize(Ty));
 
-    Solver->reset();
-    addStateConstraints(State);
+    setStateConstraints(State);
 
     // Constraints are unsatisfiable
-    ConditionTruthVal isSat = Solver->check();
+    ConditionTruthVal isSat = checkSolver();
     if (!isSat.isConstrainedTrue())
       return nullptr;
 
@@ -117,9 +127,10 @@ const llvm::APSInt *SMTConstraintManager::getSymVal(ProgramStateRef State,
                             : Solver->fromAPSInt(Value),
         false);
 
+    Solver->push();
     Solver->addConstraint(NotExp);
-
-    ConditionTruthVal isNotSat = Solver->check();
+    ConditionTruthVal isNotSat = checkSolver();
+    Solver->pop();
     if (isNotSat.isConstrainedTrue())
       return nullptr;
 
@@ -174,8 +185,25 @@ const llvm::APSInt *SMTConstraintManager::getSymVal(ProgramStateRef State,
 ConditionTruthVal
 SMTConstraintManager::checkModel(ProgramStateRef State,
                                  const SMTExprRef &Exp) const {
-  Solver->reset();
+  setStateConstraints(State);
+
+  Solver->push();
   Solver->addConstraint(Exp);
+  ConditionTruthVal Result = checkSolver();
+  Solver->pop();
+  return Result;
+}
+
+void SMTConstraintManager::setStateConstraints(ProgramStateRef State) const {
+  Solver->reset();
   addStateConstraints(State);
-  return Solver->check();
+}
+
+ConditionTruthVal SMTConstraintManager::checkSolver() const {
+  ++NumSolverQueries;
+  return timeForStatistics([&] { return Solver->check(); },
+                           [](unsigned Microseconds) {
+                             SolverTimeMicroseconds += Microseconds;
+                             MaxSolverQueryMicroseconds.updateMax(Microseconds);
+                           });
 }
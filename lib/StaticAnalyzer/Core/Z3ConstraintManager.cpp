@@ -17,6 +17,8 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/SMTSort.h"
 
 #include "clang/Config/config.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
 
 using namespace clang;
 using namespace ento;
@@ -25,6 +27,13 @@ using namespace ento;
 
 #include <z3.h>
 
+#define DEBUG_TYPE "Z3ConstraintManager"
+
+STATISTIC(NumCachedQueries,
+          "The # of satisfiability queries answered from the query cache");
+STATISTIC(NumReusedSolverStates,
+          "The # of queries made without re-adding the state constraints");
+
 namespace {
 
 /// Configuration class for Z3
@@ -155,6 +164,7 @@ static const Z3Sort &toZ3Sort(const SMTSort &S) {
 
 class Z3Expr : public SMTExpr {
   friend class Z3Solver;
+  friend class Z3ConstraintManager;
 
   Z3Context &Context;
 
@@ -908,6 +918,47 @@ public:
 class Z3ConstraintManager : public SMTConstraintManager {
   SMTSolverRef Solver = CreateZ3Solver();
 
+  /// The constraints held by the outermost scope of the solver.
+  mutable Optional<ConstraintZ3Ty> SolverConstraints;
+
+  /// A satisfiability query, made of the constraints of a state and of the
+  /// constraint being assumed. The constraint sets are canonical and Z3
+  /// uniques its ASTs, so equal queries have equal keys.
+  using QueryKey = std::pair<const void *, const void *>;
+
+  struct QueryResult {
+    // Keep the constraints and the expression of the query alive, so that
+    // their memory is not reused by another query while the result is cached.
+    ConstraintZ3Ty Constraints;
+    Z3Expr Exp;
+    ConditionTruthVal Result;
+  };
+
+  static const unsigned MaxCachedQueries = 1 << 16;
+
+  mutable llvm::DenseMap<QueryKey, QueryResult> QueryCache;
+
+  /// Check whether the given constraint is satisfiable in the state, reusing
+  /// the result of an earlier identical query if there is one.
+  ConditionTruthVal checkCachedModel(ProgramStateRef State,
+                                     const SMTExprRef &Exp) const {
+    ConstraintZ3Ty CZ = State->get<ConstraintZ3>();
+    const Z3Expr &ZExp = toZ3Expr(*Exp);
+    QueryKey Key(CZ.getRootWithoutRetain(), ZExp.AST);
+
+    auto I = QueryCache.find(Key);
+    if (I != QueryCache.end()) {
+      ++NumCachedQueries;
+      return I->second.Result;
+    }
+
+    ConditionTruthVal Result = checkModel(State, Exp);
+    if (QueryCache.size() >= MaxCachedQueries)
+      QueryCache.clear();
+    QueryCache.insert(std::make_pair(Key, QueryResult{CZ, ZExp, Result}));
+    return Result;
+  }
+
 public:
   Z3ConstraintManager(SubEngine *SE, SValBuilder &SB)
       : SMTConstraintManager(SE, SB, Solver) {}
@@ -930,6 +981,21 @@ public:
     }
   }
 
+  void setStateConstraints(ProgramStateRef State) const override {
+    // Sibling states are often queried one after the other, so the solver
+    // frequently holds the constraints of the state already.
+    ConstraintZ3Ty CZ = State->get<ConstraintZ3>();
+    if (SolverConstraints && SolverConstraints->getRootWithoutRetain() ==
+                                 CZ.getRootWithoutRetain()) {
+      ++NumReusedSolverStates;
+      return;
+    }
+
+    Solver->reset();
+    addStateConstraints(State);
+    SolverConstraints = CZ;
+  }
+
   bool canReasonAbout(SVal X) const override {
     const TargetInfo &TI = getBasicVals().getContext().getTargetInfo();
 
@@ -989,7 +1055,7 @@ public:
   ProgramStateRef assumeExpr(ProgramStateRef State, SymbolRef Sym,
                              const SMTExprRef &Exp) override {
     // Check the model, avoid simplifying AST to save time
-    if (checkModel(State, Exp).isConstrainedTrue())
+    if (checkCachedModel(State, Exp).isConstrainedTrue())
       return State->add<ConstraintZ3>(std::make_pair(Sym, toZ3Expr(*Exp)));
 
     return nullptr;
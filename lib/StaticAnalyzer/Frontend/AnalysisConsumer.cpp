@@ -12,18 +12,25 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/StaticAnalyzer/Frontend/AnalysisConsumer.h"
+#include "AnalysisResultCache.h"
 #include "ModelInjector.h"
+#include "clang/AST/Attr.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/ODRHash.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Analysis/Analyses/LiveVariables.h"
 #include "clang/Analysis/CFG.h"
 #include "clang/Analysis/CallGraph.h"
 #include "clang/Analysis/CodeInjector.h"
 #include "clang/Basic/SourceManager.h"
+#include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/Version.h"
 #include "clang/CrossTU/CrossTranslationUnit.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/StaticAnalyzer/Checkers/LocalCheckers.h"
 #include "clang/StaticAnalyzer/Core/AnalyzerOptions.h"
@@ -34,13 +41,18 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/AnalysisManager.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/ExprEngine.h"
 #include "clang/StaticAnalyzer/Frontend/CheckerRegistration.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/EquivalenceClasses.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
+#include <chrono>
 #include <memory>
 #include <queue>
 #include <utility>
@@ -62,6 +74,11 @@ STATISTIC(NumVisitedBlocksInAnalyzedFunctions,
           "The # of visited basic blocks in the analyzed functions.");
 STATISTIC(PercentReachableBlocks, "The % of reachable basic blocks.");
 STATISTIC(MaxCFGSize, "The maximum number of basic blocks in a function.");
+STATISTIC(NumFunctionsInOtherShards,
+          "The # of functions left to other analysis shards.");
+STATISTIC(NumFunctionsReusedFromCache,
+          "The # of functions not analyzed because their results were "
+          "cached.");
 
 //===----------------------------------------------------------------------===//
 // Special PathDiagnosticConsumers.
@@ -195,6 +212,14 @@ public:
   std::unique_ptr<llvm::TimerGroup> AnalyzerTimers;
   std::unique_ptr<llvm::Timer> TUTotalTimer;
 
+  /// The stream the time spent on each top level function is written to, if
+  /// requested with the 'function-timing-output' option.
+  std::unique_ptr<llvm::raw_fd_ostream> FunctionTimingOS;
+
+  /// Whether the path-sensitive analysis of the last top level function
+  /// found any bugs.
+  bool EmittedPathReports = false;
+
   /// The information about analyzed functions shared throughout the
   /// translation unit.
   FunctionSummariesTy FunctionSummaries;
@@ -206,6 +231,11 @@ public:
         PP(CI.getPreprocessor()), OutDir(outdir), Opts(std::move(opts)),
         Plugins(plugins), Injector(injector), CTU(CI) {
     DigestAnalyzerOptions();
+    if (Opts->naiveCTUEnabled())
+      CTU.setASTMemoryBudget(uint64_t(Opts->getCTUASTMemoryBudget()) << 20);
+    if (!Opts->hasValidAnalysisShardIndex())
+      PP.getDiagnostics().Report(diag::warn_analyzer_invalid_shard_index)
+          << Opts->getAnalysisShardCount() - 1;
     if (Opts->PrintStats || Opts->shouldSerializeStats()) {
       AnalyzerTimers = llvm::make_unique<llvm::TimerGroup>(
           "analyzer", "Analyzer timers");
@@ -213,6 +243,7 @@ public:
           "time", "Analyzer total time", *AnalyzerTimers);
       llvm::EnableStatistics(/* PrintOnExit= */ false);
     }
+    openFunctionTimingOutput();
   }
 
   ~AnalysisConsumer() override {
@@ -261,6 +292,34 @@ public:
     }
   }
 
+  void openFunctionTimingOutput() {
+    StringRef Path = Opts->getFunctionTimingOutput();
+    if (Path.empty())
+      return;
+
+    std::error_code EC;
+    FunctionTimingOS =
+        llvm::make_unique<llvm::raw_fd_ostream>(Path, EC, llvm::sys::fs::F_Text);
+    if (EC) {
+      PP.getDiagnostics().Report(diag::warn_analyzer_unable_to_open_output)
+          << Path << EC.message();
+      FunctionTimingOS.reset();
+      return;
+    }
+    *FunctionTimingOS
+        << "file,function,mode,time-ms,nodes,memory-bytes,stop-reason\n";
+  }
+
+  /// Open the cache of analysis results of this translation unit, if
+  /// requested with the 'result-cache-dir' option.
+  std::unique_ptr<AnalysisResultCache> openResultCache();
+
+  /// Write a line about the exploration of \p D by \p Eng to
+  /// \c FunctionTimingOS.
+  void reportFunctionTiming(const Decl *D, ExprEngine::InliningModes IMode,
+                            ExprEngine &Eng,
+                            std::chrono::steady_clock::duration Time);
+
   void DisplayFunction(const Decl *D, AnalysisMode Mode,
                        ExprEngine::InliningModes IMode) {
     if (!Opts->AnalyzerDisplayProgress)
@@ -395,6 +454,10 @@ private:
   void storeTopLevelDecls(DeclGroupRef DG);
   std::string getFunctionName(const Decl *D);
 
+  /// Returns the hash of everything the cached results of this translation
+  /// unit depend on besides the code of the analyzed functions.
+  uint64_t getResultCacheKey();
+
   /// Check if we should skip (not analyze) the given function.
   AnalysisMode getModeForDecl(Decl *D, AnalysisMode Mode);
   void runAnalysisOnTranslationUnit(ASTContext &C);
@@ -456,6 +519,186 @@ static bool shouldSkipFunction(const Decl *D,
   return Visited.count(D);
 }
 
+/// Assigns the functions of the call graph to \p ShardCount shards, so that
+/// functions that call each other end up in the same shard. Returns the shard
+/// of each function.
+///
+/// Each set of connected functions is assigned as a whole, largest first, to
+/// the shard with the fewest functions so far. The assignment only depends
+/// on the call graph, so that all analyzer processes agree on it.
+static llvm::DenseMap<const Decl *, unsigned>
+assignFunctionsToShards(CallGraph &CG, unsigned ShardCount) {
+  llvm::EquivalenceClasses<const Decl *> Connected;
+  std::vector<const Decl *> Functions;
+  llvm::ReversePostOrderTraversal<clang::CallGraph*> RPOT(&CG);
+  for (CallGraphNode *N : RPOT) {
+    const Decl *D = N->getDecl();
+    if (!D)
+      continue;
+    Functions.push_back(D);
+    Connected.insert(D);
+    for (CallGraphNode *Callee : *N)
+      if (const Decl *CalleeD = Callee->getDecl())
+        Connected.unionSets(D, CalleeD);
+  }
+
+  // Collect the sets in the order in which they are first reached, which is
+  // deterministic, and count their functions.
+  llvm::DenseMap<const Decl *, unsigned> SetIndex;
+  std::vector<std::pair<const Decl *, unsigned>> Sets;
+  for (const Decl *D : Functions) {
+    const Decl *Leader = Connected.getLeaderValue(D);
+    auto Inserted = SetIndex.insert({Leader, Sets.size()});
+    if (Inserted.second)
+      Sets.push_back({Leader, 0});
+    ++Sets[Inserted.first->second].second;
+  }
+  std::stable_sort(Sets.begin(), Sets.end(),
+                   [](const std::pair<const Decl *, unsigned> &LHS,
+                      const std::pair<const Decl *, unsigned> &RHS) {
+                     return LHS.second > RHS.second;
+                   });
+
+  llvm::DenseMap<const Decl *, unsigned> ShardOfSet;
+  std::vector<unsigned> ShardSizes(ShardCount, 0);
+  for (const auto &Set : Sets) {
+    auto Smallest = std::min_element(ShardSizes.begin(), ShardSizes.end());
+    *Smallest += Set.second;
+    ShardOfSet[Set.first] = Smallest - ShardSizes.begin();
+  }
+
+  llvm::DenseMap<const Decl *, unsigned> Shards;
+  for (const Decl *D : Functions)
+    Shards[D] = ShardOfSet[Connected.getLeaderValue(D)];
+  return Shards;
+}
+
+/// Returns the hash of the body of \p D, or None if \p D cannot be hashed.
+///
+/// Only functions outside of templates are hashed, as ODRHash does not
+/// support template specializations.
+static Optional<unsigned> getBodyHash(const Decl *D) {
+  const auto *FD = dyn_cast<FunctionDecl>(D);
+  const FunctionDecl *Definition;
+  if (!FD || !FD->hasBody(Definition))
+    return None;
+  for (const DeclContext *DC = Definition; DC; DC = DC->getParent()) {
+    if (DC->isDependentContext() || isa<ClassTemplateSpecializationDecl>(DC))
+      return None;
+    if (const auto *F = dyn_cast<FunctionDecl>(DC))
+      if (F->isTemplateInstantiation() || F->isFunctionTemplateSpecialization())
+        return None;
+    if (const auto *RD = dyn_cast<CXXRecordDecl>(DC))
+      if (RD->isLambda())
+        return None;
+  }
+
+  ODRHash Hash;
+  Hash.AddFunctionDecl(Definition);
+  // The member initializers of constructors are not part of their bodies.
+  if (const auto *Ctor = dyn_cast<CXXConstructorDecl>(Definition)) {
+    for (const CXXCtorInitializer *Init : Ctor->inits()) {
+      if (const FieldDecl *Member = Init->getAnyMember())
+        Hash.AddDecl(Member);
+      else if (const TypeSourceInfo *TSI = Init->getTypeSourceInfo())
+        Hash.AddQualType(TSI->getType());
+      Hash.AddStmt(Init->getInit());
+    }
+  }
+  return Hash.CalculateHash();
+}
+
+/// Returns the cached result of getBodyHash() for \p D.
+static Optional<unsigned>
+getCachedBodyHash(const Decl *D,
+                  llvm::DenseMap<const Decl *, Optional<unsigned>> &BodyHashes) {
+  auto I = BodyHashes.find(D);
+  if (I == BodyHashes.end())
+    I = BodyHashes.insert({D, getBodyHash(D)}).first;
+  return I->second;
+}
+
+/// Returns the hash of the body of the function of \p N and of the bodies of
+/// all the functions it may call, directly or indirectly, combined with
+/// \p GlobalsHash, or None if one of them cannot be hashed. \p BodyHashes
+/// caches the result of getBodyHash().
+static Optional<uint64_t>
+getCallGraphHash(CallGraphNode *N, uint64_t GlobalsHash,
+                 llvm::DenseMap<const Decl *, Optional<unsigned>> &BodyHashes) {
+  Optional<unsigned> OwnHash = getCachedBodyHash(N->getDecl(), BodyHashes);
+  if (!OwnHash)
+    return None;
+
+  // The order in which the callees are reached depends on the order of the
+  // calls, which is already part of the hash of the caller.
+  llvm::SmallPtrSet<CallGraphNode *, 16> Reached;
+  SmallVector<CallGraphNode *, 16> Worklist;
+  Reached.insert(N);
+  Worklist.push_back(N);
+  llvm::hash_code Code = llvm::hash_combine(GlobalsHash, *OwnHash);
+  while (!Worklist.empty()) {
+    CallGraphNode *Caller = Worklist.pop_back_val();
+    for (CallGraphNode *Callee : *Caller) {
+      if (!Reached.insert(Callee).second)
+        continue;
+      Optional<unsigned> CalleeHash =
+          getCachedBodyHash(Callee->getDecl(), BodyHashes);
+      if (!CalleeHash)
+        return None;
+      Code = llvm::hash_combine(Code, *CalleeHash);
+      Worklist.push_back(Callee);
+    }
+  }
+  return static_cast<uint64_t>(size_t(Code));
+}
+
+/// Combines into \p Code the hash of the declarations in \p DC that the
+/// analysis of a function may depend on besides the function bodies:
+/// variables and their initializers, records, enums, typedefs, and the
+/// signatures and attributes of functions.
+static void addDeclContextHash(const DeclContext *DC,
+                               const PrintingPolicy &Policy,
+                               llvm::hash_code &Code) {
+  for (const Decl *D : DC->decls()) {
+    if (D->isImplicit())
+      continue;
+    if (const auto *CTD = dyn_cast<ClassTemplateDecl>(D))
+      D = CTD->getTemplatedDecl();
+    else if (const auto *FTD = dyn_cast<FunctionTemplateDecl>(D))
+      D = FTD->getTemplatedDecl();
+
+    ODRHash Hash;
+    if (const auto *FD = dyn_cast<FunctionDecl>(D)) {
+      Hash.AddFunctionDecl(FD, /*SkipBody=*/true);
+    } else if (const auto *ED = dyn_cast<EnumDecl>(D)) {
+      Hash.AddEnumDecl(ED);
+    } else if (isa<VarDecl>(D) || isa<FieldDecl>(D) ||
+               isa<TypedefNameDecl>(D)) {
+      Hash.AddSubDecl(D);
+    } else {
+      Hash.AddDecl(D);
+      // The members of records are hashed below, but not their bases.
+      if (const auto *RD = dyn_cast<CXXRecordDecl>(D))
+        if (RD->isThisDeclarationADefinition())
+          for (const CXXBaseSpecifier &Base : RD->bases())
+            Hash.AddQualType(Base.getType());
+    }
+    Code = llvm::hash_combine(Code, D->getKind(), Hash.CalculateHash());
+
+    if (D->hasAttrs()) {
+      std::string Attrs;
+      llvm::raw_string_ostream OS(Attrs);
+      for (const Attr *A : D->attrs())
+        A->printPretty(OS, Policy);
+      Code = llvm::hash_combine(Code, OS.str());
+    }
+
+    if (isa<NamespaceDecl>(D) || isa<LinkageSpecDecl>(D) ||
+        isa<ExportDecl>(D) || isa<RecordDecl>(D))
+      addDeclContextHash(cast<DeclContext>(D), Policy, Code);
+  }
+}
+
 ExprEngine::InliningModes
 AnalysisConsumer::getInliningModeForFunction(const Decl *D,
                                              const SetOfConstDecls &Visited) {
@@ -487,6 +730,64 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
   // inlined functions. The topological order allows the "do not reanalyze
   // previously inlined function" performance heuristic to be triggered more
   // often.
+  //
+  // When the analysis is split into shards, only analyze the functions of
+  // this shard.
+  unsigned ShardCount = Mgr->options.getAnalysisShardCount();
+  unsigned ShardIndex =
+      ShardCount > 1 ? Mgr->options.getAnalysisShardIndex() : 0;
+  llvm::DenseMap<const Decl *, unsigned> Shards;
+  if (ShardCount > 1)
+    Shards = assignFunctionsToShards(CG, ShardCount);
+
+  // When the results are cached, the functions that produced no reports in
+  // the previous run are skipped if neither they nor the functions they call
+  // changed. The functions are identified by their names, so functions whose
+  // name is not unique are always analyzed.
+  //
+  // The analysis of a function also depends on the global declarations, such
+  // as the initializers of constants and the layout of records. They are not
+  // tracked per function, so a change to any of them invalidates every
+  // cached function. The functions inlined through virtual calls or function
+  // pointers are not in the call graph, so the ones inlined in the previous
+  // run are hashed along with the function.
+  std::unique_ptr<AnalysisResultCache> ResultCache = openResultCache();
+  llvm::DenseMap<const Decl *, Optional<unsigned>> BodyHashes;
+  llvm::StringMap<const Decl *> DeclsByName;
+  uint64_t GlobalsHash = 0;
+  if (ResultCache) {
+    for (const auto &I : CG) {
+      const Decl *D = I.getFirst();
+      if (!D)
+        continue;
+      auto Inserted = DeclsByName.insert({getFunctionName(D), D});
+      if (!Inserted.second)
+        Inserted.first->second = nullptr;
+    }
+    llvm::hash_code Code = llvm::hash_value(0);
+    addDeclContextHash(Ctx->getTranslationUnitDecl(), Ctx->getPrintingPolicy(),
+                       Code);
+    GlobalsHash = static_cast<uint64_t>(size_t(Code));
+  }
+
+  // Combines Hash with the bodies of the inlined functions named in Callees,
+  // which must be sorted.
+  auto addInlinedHash =
+      [&](uint64_t Hash,
+          ArrayRef<std::string> Callees) -> Optional<uint64_t> {
+    llvm::hash_code Code = llvm::hash_value(Hash);
+    for (const std::string &Callee : Callees) {
+      const Decl *CalleeD = DeclsByName.lookup(Callee);
+      if (!CalleeD)
+        return None;
+      Optional<unsigned> CalleeHash = getCachedBodyHash(CalleeD, BodyHashes);
+      if (!CalleeHash)
+        return None;
+      Code = llvm::hash_combine(Code, Callee, *CalleeHash);
+    }
+    return static_cast<uint64_t>(size_t(Code));
+  };
+
   SetOfConstDecls Visited;
   SetOfConstDecls VisitedAsTopLevel;
   llvm::ReversePostOrderTraversal<clang::CallGraph*> RPOT(&CG);
@@ -501,17 +802,62 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
     if (!D)
       continue;
 
+    // Skip the functions analyzed by other shards.
+    if (ShardCount > 1 && Shards.lookup(D) != ShardIndex) {
+      ++NumFunctionsInOtherShards;
+      continue;
+    }
+
     // Skip the functions which have been processed already or previously
     // inlined.
     if (shouldSkipFunction(D, Visited, VisitedAsTopLevel))
       continue;
 
+    Optional<uint64_t> Hash;
+    std::string Name;
+    if (ResultCache) {
+      Name = getFunctionName(D);
+      if (DeclsByName.lookup(Name) == D)
+        Hash = getCallGraphHash(N, GlobalsHash, BodyHashes);
+    }
+
+    if (Hash) {
+      if (const AnalysisResultCache::Entry *Cached =
+              ResultCache->lookup(Name)) {
+        Optional<uint64_t> FullHash =
+            addInlinedHash(*Hash, Cached->VisitedCallees);
+        if (FullHash && *FullHash == Cached->Hash) {
+          for (const std::string &Callee : Cached->VisitedCallees)
+            Visited.insert(DeclsByName.lookup(Callee));
+          VisitedAsTopLevel.insert(D);
+          ResultCache->insert(Name, *Cached);
+          ++NumFunctionsReusedFromCache;
+          continue;
+        }
+      }
+    }
+
     // Analyze the function.
     SetOfConstDecls VisitedCallees;
 
+    EmittedPathReports = false;
     HandleCode(D, AM_Path, getInliningModeForFunction(D, Visited),
                (Mgr->options.InliningMode == All ? nullptr : &VisitedCallees));
 
+    // Only remember the functions without reports, so that the reports are
+    // always produced by an actual analysis.
+    if (Hash && !EmittedPathReports) {
+      AnalysisResultCache::Entry E;
+      for (const Decl *Callee : VisitedCallees)
+        E.VisitedCallees.push_back(getFunctionName(Callee));
+      llvm::sort(E.VisitedCallees.begin(), E.VisitedCallees.end());
+      if (Optional<uint64_t> FullHash =
+              addInlinedHash(*Hash, E.VisitedCallees)) {
+        E.Hash = *FullHash;
+        ResultCache->insert(Name, std::move(E));
+      }
+    }
+
     // Add the visited callees to the global visited set.
     for (const Decl *Callee : VisitedCallees)
       // Decls from CallGraph are already canonical. But Decls coming from
@@ -520,6 +866,11 @@ void AnalysisConsumer::HandleDeclsCallGraph(const unsigned LocalTUDeclsSize) {
                                                  : Callee->getCanonicalDecl());
     VisitedAsTopLevel.insert(D);
   }
+
+  if (ResultCache)
+    if (std::error_code EC = ResultCache->save())
+      PP.getDiagnostics().Report(diag::warn_analyzer_unable_to_open_output)
+          << ResultCache->getPath() << EC.message();
 }
 
 static bool isBisonFile(ASTContext &C) {
@@ -532,6 +883,16 @@ static bool isBisonFile(ASTContext &C) {
 }
 
 void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
+  // When the path-sensitive analysis is split into shards, the AST-based
+  // checks only run in the first one. Without inlining, the path-sensitive
+  // analysis is not split, and also only runs in the first shard.
+  if (Mgr->options.getAnalysisShardCount() > 1 &&
+      Mgr->options.getAnalysisShardIndex() != 0) {
+    if (Mgr->shouldInlineCall())
+      HandleDeclsCallGraph(LocalTUDecls.size());
+    return;
+  }
+
   BugReporter BR(*Mgr);
   TranslationUnitDecl *TU = C.getTranslationUnitDecl();
   checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
@@ -608,6 +969,110 @@ void AnalysisConsumer::HandleTranslationUnit(ASTContext &C) {
   Mgr.reset();
 }
 
+/// Print \p Field as a field of a comma-separated values file.
+static void printCSVField(raw_ostream &OS, StringRef Field) {
+  if (Field.find_first_of(",\"\n") == StringRef::npos) {
+    OS << Field;
+    return;
+  }
+  OS << '"';
+  for (char C : Field) {
+    if (C == '"')
+      OS << '"';
+    OS << C;
+  }
+  OS << '"';
+}
+
+static StringRef getStopReasonName(CoreEngine::StopReason Reason) {
+  switch (Reason) {
+  case CoreEngine::StopReason::WorkListEmpty:
+    return "done";
+  case CoreEngine::StopReason::MaxSteps:
+    return "max-nodes";
+  case CoreEngine::StopReason::TimeBudget:
+    return "time-budget";
+  case CoreEngine::StopReason::MemoryBudget:
+    return "memory-budget";
+  }
+  llvm_unreachable("Unknown stop reason");
+}
+
+void AnalysisConsumer::reportFunctionTiming(
+    const Decl *D, ExprEngine::InliningModes IMode, ExprEngine &Eng,
+    std::chrono::steady_clock::duration Time) {
+  raw_ostream &OS = *FunctionTimingOS;
+  PresumedLoc Loc =
+      Mgr->getASTContext().getSourceManager().getPresumedLoc(D->getLocation());
+  printCSVField(OS, Loc.isValid() ? Loc.getFilename() : "");
+  OS << ',';
+  printCSVField(OS, getFunctionName(D));
+  OS << ','
+     << (IMode == ExprEngine::Inline_Minimal ? "Inline_Minimal"
+                                             : "Inline_Regular")
+     << ','
+     << std::chrono::duration_cast<std::chrono::milliseconds>(Time).count()
+     << ',' << Eng.getGraph().size() << ','
+     << Eng.getGraph().getAllocator().getTotalMemory() << ','
+     << getStopReasonName(Eng.getCoreEngine().getStopReason()) << '\n';
+}
+
+uint64_t AnalysisConsumer::getResultCacheKey() {
+  using llvm::hash_combine;
+
+  const SourceManager &SM = Ctx->getSourceManager();
+  llvm::hash_code Code = hash_combine(
+      getClangFullRepositoryVersion(),
+      Ctx->getTargetInfo().getTriple().str(),
+      SM.getFileEntryForID(SM.getMainFileID())->getName());
+
+  std::vector<std::pair<StringRef, StringRef>> Config;
+  for (const auto &I : Opts->Config)
+    Config.push_back({I.getKey(), I.getValue()});
+  llvm::sort(Config.begin(), Config.end());
+  for (const auto &I : Config)
+    Code = hash_combine(Code, I.first, I.second);
+  for (const auto &I : Opts->CheckersControlList)
+    Code = hash_combine(Code, I.first, I.second);
+
+  Code = hash_combine(
+      Code, Opts->AnalysisStoreOpt, Opts->AnalysisConstraintsOpt,
+      Opts->AnalysisPurgeOpt, Opts->InliningMode, Opts->maxBlockVisitOnPath,
+      Opts->InlineMaxStackDepth, bool(Opts->AnalyzeAll),
+      bool(Opts->AnalyzeNestedBlocks),
+      bool(Opts->eagerlyAssumeBinOpBifurcation), bool(Opts->UnoptimizedCFG),
+      bool(Opts->NoRetryExhausted));
+  return static_cast<uint64_t>(size_t(Code));
+}
+
+std::unique_ptr<AnalysisResultCache> AnalysisConsumer::openResultCache() {
+  StringRef Dir = Opts->getResultCacheDir();
+  // The results of a single function or of cross translation unit analysis
+  // do not describe the translation unit.
+  if (Dir.empty() || !Opts->AnalyzeSpecificFunction.empty() ||
+      Opts->naiveCTUEnabled())
+    return nullptr;
+
+  const SourceManager &SM = Ctx->getSourceManager();
+  const FileEntry *MainFile = SM.getFileEntryForID(SM.getMainFileID());
+  if (!MainFile)
+    return nullptr;
+
+  if (std::error_code EC = llvm::sys::fs::create_directories(Dir)) {
+    PP.getDiagnostics().Report(diag::warn_analyzer_unable_to_open_output)
+        << Dir << EC.message();
+    return nullptr;
+  }
+
+  // Different files with the same name get different keys, and thus
+  // different cache files.
+  uint64_t Key = getResultCacheKey();
+  SmallString<128> Path(Dir);
+  llvm::sys::path::append(Path, llvm::sys::path::filename(MainFile->getName()) +
+                                    "-" + llvm::utohexstr(Key) + ".txt");
+  return llvm::make_unique<AnalysisResultCache>(Path, Key);
+}
+
 std::string AnalysisConsumer::getFunctionName(const Decl *D) {
   std::string Str;
   llvm::raw_string_ostream OS(Str);
@@ -751,8 +1216,12 @@ void AnalysisConsumer::ActionExprEngine(Decl *D, bool ObjCGCEnabled,
   }
 
   // Execute the worklist algorithm.
+  auto StartTime = std::chrono::steady_clock::now();
   Eng.ExecuteWorkList(Mgr->getAnalysisDeclContextManager().getStackFrame(D),
                       Mgr->options.getMaxNodesPerTopLevelFunction());
+  if (FunctionTimingOS)
+    reportFunctionTiming(D, IMode, Eng,
+                         std::chrono::steady_clock::now() - StartTime);
 
   // Release the auditor (if any) so that it doesn't monitor the graph
   // created BugReporter.
@@ -763,7 +1232,10 @@ void AnalysisConsumer::ActionExprEngine(Decl *D, bool ObjCGCEnabled,
     Eng.ViewGraph(Mgr->options.TrimGraph);
 
   // Display warnings.
-  Eng.getBugReporter().FlushReports();
+  BugReporter &BR = Eng.getBugReporter();
+  if (BR.EQClasses_begin() != BR.EQClasses_end())
+    EmittedPathReports = true;
+  BR.FlushReports();
 }
 
 void AnalysisConsumer::RunPathSensitiveChecks(Decl *D,
@@ -0,0 +1,105 @@
+//===-- AnalysisResultCache.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// The results are stored in a text file. The first line holds the key of the
+// translation unit. Each following line describes one function by its hash,
+// its name and the names of the functions inlined into it, separated by tabs.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AnalysisResultCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <tuple>
+
+using namespace clang;
+using namespace ento;
+
+AnalysisResultCache::AnalysisResultCache(StringRef Path, uint64_t Key)
+    : Path(Path), Key(Key) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> BufferOrErr =
+      llvm::MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!BufferOrErr)
+    return;
+
+  StringRef Line, Remaining = (*BufferOrErr)->getBuffer();
+  std::tie(Line, Remaining) = Remaining.split('\n');
+  uint64_t StoredKey;
+  if (!Line.consume_front("key ") || Line.getAsInteger(16, StoredKey) ||
+      StoredKey != Key)
+    return;
+
+  while (!Remaining.empty()) {
+    std::tie(Line, Remaining) = Remaining.split('\n');
+    SmallVector<StringRef, 8> Fields;
+    Line.split(Fields, '\t');
+    Entry E;
+    // A malformed file is not trusted at all.
+    if (Fields.size() < 2 || Fields[0].getAsInteger(16, E.Hash)) {
+      StoredEntries.clear();
+      return;
+    }
+    for (StringRef Callee : llvm::makeArrayRef(Fields).drop_front(2))
+      E.VisitedCallees.push_back(Callee);
+    StoredEntries[Fields[1]] = std::move(E);
+  }
+}
+
+const AnalysisResultCache::Entry *
+AnalysisResultCache::lookup(StringRef FunctionName) const {
+  auto I = StoredEntries.find(FunctionName);
+  if (I == StoredEntries.end())
+    return nullptr;
+  return &I->second;
+}
+
+void AnalysisResultCache::insert(StringRef FunctionName, Entry E) {
+  NewEntries[FunctionName] = std::move(E);
+}
+
+std::error_code AnalysisResultCache::save() const {
+  // Write to a temporary file and rename it, so that concurrent runs on the
+  // same translation unit do not see a partially written file.
+  SmallString<128> TempPath;
+  TempPath = Path;
+  TempPath += "-%%%%%%%%";
+  int FD;
+  if (std::error_code EC =
+          llvm::sys::fs::createUniqueFile(TempPath, FD, TempPath))
+    return EC;
+
+  llvm::raw_fd_ostream Out(FD, /*shouldClose=*/true);
+  Out << "key ";
+  Out.write_hex(Key);
+  Out << '\n';
+  for (const auto &I : NewEntries) {
+    Out.write_hex(I.second.Hash);
+    Out << '\t' << I.getKey();
+    for (const std::string &Callee : I.second.VisitedCallees)
+      Out << '\t' << Callee;
+    Out << '\n';
+  }
+  Out.close();
+  if (Out.has_error()) {
+    std::error_code EC = Out.error();
+    Out.clear_error();
+    llvm::sys::fs::remove(TempPath);
+    return EC;
+  }
+
+  if (std::error_code EC = llvm::sys::fs::rename(TempPath, Path)) {
+    llvm::sys::fs::remove(TempPath);
+    return EC;
+  }
+  return std::error_code();
+}
@@ -0,0 +1,71 @@
+//===-- AnalysisResultCache.h -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines the clang::ento::AnalysisResultCache class, which
+/// remembers the top-level functions of a translation unit whose
+/// path-sensitive analysis produced no reports. When the analyzer runs again
+/// on the translation unit, such a function need not be analyzed as long as
+/// neither its body, the bodies of the functions it calls, nor the global
+/// declarations of the translation unit have changed.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_SA_FRONTEND_ANALYSISRESULTCACHE_H
+#define LLVM_CLANG_SA_FRONTEND_ANALYSISRESULTCACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/StringMap.h"
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace clang {
+namespace ento {
+
+class AnalysisResultCache {
+public:
+  struct Entry {
+    /// The hash of the function, of everything it calls, of the global
+    /// declarations, and of the functions inlined into it.
+    uint64_t Hash;
+    /// The functions that were inlined into the function, which therefore
+    /// need not be analyzed as top-level functions.
+    std::vector<std::string> VisitedCallees;
+  };
+
+  /// Read the results stored in \p Path, if any. \p Key identifies the
+  /// translation unit and the analyzer configuration; results stored with a
+  /// different key are ignored.
+  AnalysisResultCache(StringRef Path, uint64_t Key);
+
+  /// Returns the stored entry for \p FunctionName, if any. The caller
+  /// compares its hash, which covers the functions inlined into it.
+  const Entry *lookup(StringRef FunctionName) const;
+
+  /// Record that \p FunctionName produced no reports in this run.
+  void insert(StringRef FunctionName, Entry E);
+
+  /// Replace the stored results with the ones recorded in this run.
+  std::error_code save() const;
+
+  StringRef getPath() const { return Path; }
+
+private:
+  std::string Path;
+  uint64_t Key;
+  llvm::StringMap<Entry> StoredEntries;
+  llvm::StringMap<Entry> NewEntries;
+};
+
+} // end namespace ento
+} // end namespace clang
+
+#endif
@@ -319,6 +319,7 @@ bool ToolInvocation::run() {
     Invocation->getPreprocessorOpts().addRemappedFile(It.getKey(),
                                                       Input.release());
   }
+  Invocation->getPreprocessorOpts().SharedModuleFiles = SharedModuleFiles;
   return runInvocation(BinaryName, Compilation.get(), std::move(Invocation),
                        std::move(PCHContainerOps));
 }
@@ -492,6 +493,7 @@ int ClangTool::run(ToolAction *Action) {
       ToolInvocation Invocation(std::move(CommandLine), Action, Files.get(),
                                 PCHContainerOps);
       Invocation.setDiagnosticConsumer(DiagConsumer);
+      Invocation.setSharedModuleCache(SharedModuleFiles);
 
       if (!Invocation.run()) {
         // FIXME: Diagnostics should be used instead.
@@ -0,0 +1,30 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.Stats -analyzer-config graph-trim-interval=0 -verify=untrimmed %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.Stats -analyzer-config graph-trim-interval=1 -verify=default %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.Stats -analyzer-config graph-trim-interval=1,aggressive-graph-trim=true -verify=trimmed %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config graph-trim-interval=1,aggressive-graph-trim=true -verify=core %s
+
+// The dead symbol cleanup nodes are tagged, so only the aggressive mode
+// reclaims them.
+int compute(int a, int b) {
+  // untrimmed-warning-re@-1{{compute -> Total CFGBlocks: {{[0-9]+}} | Unreachable CFGBlocks: 0 | Exhausted Block: no | Empty WorkList: yes | Graph Nodes: {{[0-9]+}} | Reclaimed Nodes: 0 | Reclaimed Tagged Nodes: 0 | Graph Memory: {{[0-9]+}} bytes}}
+  // default-warning-re@-2{{compute -> Total CFGBlocks: {{[0-9]+}} | Unreachable CFGBlocks: 0 | Exhausted Block: no | Empty WorkList: yes | Graph Nodes: {{[0-9]+}} | Reclaimed Nodes: {{[0-9]+}} | Reclaimed Tagged Nodes: 0 | Graph Memory: {{[0-9]+}} bytes}}
+  // trimmed-warning-re@-3{{compute -> Total CFGBlocks: {{[0-9]+}} | Unreachable CFGBlocks: 0 | Exhausted Block: no | Empty WorkList: yes | Graph Nodes: {{[0-9]+}} | Reclaimed Nodes: {{[1-9][0-9]*}} | Reclaimed Tagged Nodes: {{[1-9][0-9]*}} | Graph Memory: {{[0-9]+}} bytes}}
+  int x = a + b;
+  x = x * 2;
+  a = b;
+  b = x;
+  return a + b;
+}
+
+// Reclaiming the cleanup nodes must not lose bugs.
+int divide(int a) {
+  // untrimmed-warning-re@-1{{divide -> Total CFGBlocks}}
+  // default-warning-re@-2{{divide -> Total CFGBlocks}}
+  // trimmed-warning-re@-3{{divide -> Total CFGBlocks}}
+  int zero = 0;
+  a = a + 1;
+  return a / zero; // untrimmed-warning{{Division by zero}}
+                   // default-warning@-1{{Division by zero}}
+                   // trimmed-warning@-2{{Division by zero}}
+                   // core-warning@-3{{Division by zero}}
+}
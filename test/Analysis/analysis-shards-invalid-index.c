@@ -0,0 +1,12 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config shard-count=2,shard-index=5 %s 2>&1 | FileCheck %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config shard-count=2,shard-index=-1 %s 2>&1 | FileCheck %s
+
+// An index out of range analyzes the first shard, which holds the only
+// function here, instead of nothing.
+
+// CHECK: warning: analyzer-config option 'shard-index' should be between 0 and 1; analyzing shard 0 instead
+// CHECK: warning: Dereference of null pointer
+void f() {
+  int *p = 0;
+  *p = 1;
+}
@@ -0,0 +1,43 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode.DeadStores -analyzer-config shard-count=2,shard-index=0 -DSHARD=0 -verify %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode.DeadStores -analyzer-config shard-count=2,shard-index=1 -DSHARD=1 -verify %s
+
+// The caller and the callee are analyzed in the same shard, so the null
+// pointer passed by the caller is still found when the callee is inlined.
+void callee(int *p) {
+#if SHARD == 0
+  *p = 1; // expected-warning{{Dereference of null pointer}}
+#else
+  *p = 1;
+#endif
+}
+
+void caller() {
+  callee(0);
+}
+
+// The remaining functions go to the other shard.
+int first() {
+  int x = 0;
+#if SHARD == 1
+  return 1 / x; // expected-warning{{Division by zero}}
+#else
+  return 1 / x;
+#endif
+}
+
+int second() {
+  int y = 0;
+  int z;
+  // AST-based checks only run in the first shard.
+#if SHARD == 0
+  z = 1; // expected-warning{{Value stored to 'z' is never read}}
+#else
+  z = 1;
+#endif
+  z = 2;
+#if SHARD == 1
+  return z / y; // expected-warning{{Division by zero}}
+#else
+  return z / y;
+#endif
+}
@@ -0,0 +1,11 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.Stats -verify %s
+
+int noBindings() { // expected-warning-re{{noBindings -> {{.*}} | States: {{[1-9][0-9]*}} | Max Store Bindings: 0 | Max Environment Bindings: {{[0-9]+}}}}
+  return 0;
+}
+
+int bindings(int a) { // expected-warning-re{{bindings -> {{.*}} | States: {{[1-9][0-9]*}} | Max Store Bindings: {{[1-9][0-9]*}} | Max Environment Bindings: {{[1-9][0-9]*}}}}
+  int x = 1;
+  int y = x + a;
+  return x + y;
+}
@@ -0,0 +1,45 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-output=text -verify %s
+
+// The paths of the reports of a function are found in a graph shared by all
+// of them. Each report must still get the path leading to its own error node.
+
+void twoReports(int x) {
+  int *p = 0; // expected-note{{'p' initialized to a null pointer value}}
+  int *q = 0; // expected-note{{'q' initialized to a null pointer value}}
+  if (x) {
+    // expected-note@-1{{Assuming 'x' is not equal to 0}}
+    // expected-note@-2{{Taking true branch}}
+    // expected-note@-3{{Assuming 'x' is 0}}
+    // expected-note@-4{{Taking false branch}}
+    *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+            // expected-note@-1{{Dereference of null pointer (loaded from variable 'p')}}
+  } else {
+    *q = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'q')}}
+            // expected-note@-1{{Dereference of null pointer (loaded from variable 'q')}}
+  }
+}
+
+// Both branches on coin() reach the reports through the same node, along
+// paths of the same length. The order of the edges in the shared graph
+// decides which of them is shown, as it would without the shared graph.
+int coin(void);
+
+void tieBreak(int x) {
+  int *p = 0; // expected-note 2 {{'p' initialized to a null pointer value}}
+  if (coin()) {
+    // expected-note@-1 2 {{Assuming the condition is true}}
+    // expected-note@-2 2 {{Taking true branch}}
+  } else {
+  }
+  if (x) {
+    // expected-note@-1{{Assuming 'x' is not equal to 0}}
+    // expected-note@-2{{Taking true branch}}
+    // expected-note@-3{{Assuming 'x' is 0}}
+    // expected-note@-4{{Taking false branch}}
+    *p = 1; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+            // expected-note@-1{{Dereference of null pointer (loaded from variable 'p')}}
+  } else {
+    *p = 2; // expected-warning{{Dereference of null pointer (loaded from variable 'p')}}
+            // expected-note@-1{{Dereference of null pointer (loaded from variable 'p')}}
+  }
+}
@@ -0,0 +1,37 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config max-nodes=20,function-timing-output=%t.csv %s
+// RUN: FileCheck --input-file=%t.csv %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config max-nodes=1000000,max-time-per-function=1,function-timing-output=%t.time.csv %s
+// RUN: FileCheck --check-prefix=TIME --input-file=%t.time.csv %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config max-nodes=1000000,max-memory-per-function=1,function-timing-output=%t.memory.csv %s
+// RUN: FileCheck --check-prefix=MEMORY --input-file=%t.memory.csv %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config function-timing-output=%t.missing/timing.csv %s 2>&1 | FileCheck --check-prefix=NO-FILE %s
+
+// CHECK: file,function,mode,time-ms,nodes,memory-bytes,stop-reason
+// CHECK-DAG: {{.*}}function-timing-output.c,empty,Inline_Regular,{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},done
+// CHECK-DAG: {{.*}}function-timing-output.c,loop,Inline_Regular,{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},max-nodes
+
+// TIME: {{.*}}function-timing-output.c,branches,Inline_Regular,{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},time-budget
+
+// MEMORY: {{.*}}function-timing-output.c,branches,Inline_Regular,{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},memory-budget
+
+// NO-FILE: warning: unable to open analyzer output file '{{.*}}timing.csv'
+
+void empty() {}
+
+int loop(int n) {
+  int sum = 0;
+  for (int i = 0; i < n; ++i)
+    sum += i;
+  return sum;
+}
+
+// Every branch doubles the number of paths, so exploring this function
+// runs out of any small budget long before the node limit.
+#define BRANCH(N) if (flags & (1u << N)) sum += N;
+int branches(unsigned flags) {
+  int sum = 0;
+  BRANCH(0) BRANCH(1) BRANCH(2) BRANCH(3) BRANCH(4) BRANCH(5) BRANCH(6)
+  BRANCH(7) BRANCH(8) BRANCH(9) BRANCH(10) BRANCH(11) BRANCH(12) BRANCH(13)
+  BRANCH(14) BRANCH(15) BRANCH(16) BRANCH(17) BRANCH(18) BRANCH(19)
+  return sum;
+}
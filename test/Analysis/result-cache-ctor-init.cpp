@@ -0,0 +1,23 @@
+// RUN: rm -rf %t
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -verify %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -verify -DCHANGED_INIT %s
+
+// A change to a member initializer of a constructor invalidates its result,
+// even though the body of the constructor is unchanged.
+struct S {
+  int *p;
+  S(int *x)
+#ifdef CHANGED_INIT
+      : p(nullptr) {
+    *p = 1; // expected-warning{{Dereference of null pointer}}
+  }
+#else
+      : p(x) {
+    *p = 1;
+  }
+#endif
+};
+
+#ifndef CHANGED_INIT
+// expected-no-diagnostics
+#endif
@@ -0,0 +1,42 @@
+// RUN: rm -rf %t
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -verify %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -verify -DCHANGED_GLOBAL %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -verify %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -verify -DCHANGED_TARGET %s
+
+// A change to the initializer of a global constant invalidates the results
+// of the functions that read it, even though their bodies are unchanged.
+#ifdef CHANGED_GLOBAL
+const int d = 0;
+#else
+const int d = 1;
+#endif
+
+int divide(int x) {
+#ifdef CHANGED_GLOBAL
+  return x / d; // expected-warning{{Division by zero}}
+#else
+  return x / d;
+#endif
+}
+
+// A change to a function inlined through a function pointer invalidates the
+// results of its caller, although the call graph has no edge between them.
+void target(int *p) {
+#ifdef CHANGED_TARGET
+  int z = 0;
+  *p = 1 / z; // expected-warning{{Division by zero}}
+#else
+  *p = 1;
+#endif
+}
+
+void viaPointer() {
+  void (*f)(int *) = target;
+  int x;
+  f(&x);
+}
+
+#if !defined(CHANGED_GLOBAL) && !defined(CHANGED_TARGET)
+// expected-no-diagnostics
+#endif
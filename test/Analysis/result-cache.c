@@ -0,0 +1,36 @@
+// RUN: rm -rf %t
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -analyzer-display-progress -verify %s 2>&1 | FileCheck --check-prefix=FIRST %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -analyzer-display-progress -verify %s 2>&1 | FileCheck --check-prefix=SECOND %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-config result-cache-dir=%t -analyzer-display-progress -verify -DCHANGED %s 2>&1 | FileCheck --check-prefix=CHANGED %s
+
+void callee(int *p) {
+#ifdef CHANGED
+  *p = 2;
+#else
+  *p = 1;
+#endif
+}
+
+void clean() {
+  int x;
+  callee(&x);
+}
+
+int buggy(int a) {
+  int z = 0;
+  return a / z; // expected-warning{{Division by zero}}
+}
+
+// All functions are analyzed in the first run.
+// FIRST-DAG: Inline_Regular): {{.*}}result-cache.c clean
+// FIRST-DAG: Inline_Regular): {{.*}}result-cache.c buggy
+
+// The function without reports is reused, along with the function inlined
+// into it. The function with a report is analyzed again.
+// SECOND-NOT: Inline_Regular): {{.*}}result-cache.c c{{(allee|lean)}}
+// SECOND: Inline_Regular): {{.*}}result-cache.c buggy
+// SECOND-NOT: Inline_Regular): {{.*}}result-cache.c c{{(allee|lean)}}
+
+// A change to a callee invalidates the results of its callers.
+// CHANGED-DAG: Inline_Regular): {{.*}}result-cache.c clean
+// CHANGED-DAG: Inline_Regular): {{.*}}result-cache.c buggy
@@ -0,0 +1,35 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.ExprInspection -verify=nomerge %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.ExprInspection -analyzer-config state-merging=true -verify=merge %s
+
+void clang_analyzer_numTimesReached();
+
+// The symbols stay alive until the return, so the paths that took different
+// branches differ in their constraints. Without merging, each if-statement
+// doubles the number of paths. With merging, every path that reaches the
+// call is less constrained than the previous ones, so there are at most
+// five of them.
+int sequentialBranches(int a, int b, int c, int d) {
+  if (a) {}
+  if (b) {}
+  if (c) {}
+  if (d) {}
+  clang_analyzer_numTimesReached(); // nomerge-warning{{16}} merge-warning-re{{{{^[1-5]$}}}}
+  return a + b + c + d;
+}
+
+// The joined state allows the values of both paths, so bugs are still found.
+void bugAfterJoin(int a) {
+  int *p = 0;
+  if (a) {}
+  if (a)
+    *p = 1; // nomerge-warning{{Dereference of null pointer}} merge-warning{{Dereference of null pointer}}
+}
+
+// Paths whose stores differ are not merged.
+int differentStores(int a) {
+  int x = 0;
+  if (a)
+    x = 1;
+  clang_analyzer_numTimesReached(); // nomerge-warning{{2}} merge-warning{{2}}
+  return x + a;
+}
@@ -0,0 +1,15 @@
+// REQUIRES: z3, asserts
+// RUN: %clang_analyze_cc1 -analyzer-checker=core -analyzer-constraints=z3 -analyzer-stats -verify %s 2>&1 | FileCheck %s
+// expected-no-diagnostics
+
+// Both branches of the condition are checked against the constraints of the
+// same state, so the second check reuses the constraints held by the solver.
+int branch(int x) {
+  if (x > 10)
+    return 1;
+  return 0;
+}
+
+// CHECK: ... Statistics Collected ...
+// CHECK: {{[1-9][0-9]*}} SMTConstraintManager - The # of queries made to the SMT solver
+// CHECK: {{[1-9][0-9]*}} Z3ConstraintManager - The # of queries made without re-adding the state constraints
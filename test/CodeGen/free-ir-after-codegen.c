@@ -0,0 +1,33 @@
+// REQUIRES: x86-registered-target
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -O1 -debug-info-kind=limited -S %s -o %t.default.s
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -O1 -debug-info-kind=limited -S -ffree-ir-after-codegen %s -o %t.freed.s
+// RUN: diff %t.default.s %t.freed.s
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -S -ffree-ir-after-codegen -ftime-report %s -o /dev/null 2>&1 | FileCheck %s
+
+// Freeing the IR of emitted functions does not change the generated code.
+
+static int callee(int x) { return x * 3; }
+
+int caller(int x) { return callee(x) + callee(x + 1); }
+
+__attribute__((visibility("hidden"))) int recursive(int n) {
+  return n <= 1 ? 1 : n * recursive(n - 1);
+}
+
+int computedGoto(int i) {
+  static void *targets[] = {&&a, &&b};
+  goto *targets[i & 1];
+a:
+  return 1;
+b:
+  return 2;
+}
+
+int (*pointer)(int) = callee;
+
+// CHECK: Backend Memory Usage
+// CHECK: Peak (KB)   At End (KB)   Phase
+// CHECK: IR generation
+// CHECK: Per-function optimization
+// CHECK: Per-module optimization and IR output
+// CHECK: Code generation
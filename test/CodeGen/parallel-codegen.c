@@ -0,0 +1,52 @@
+// REQUIRES: x86-registered-target, system-linker
+
+// The object generated in parts is the same on every run, and defines the
+// same symbols as the one generated serially.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj -fparallel-codegen=4 -fparallel-codegen-linker %clang %s -o %t.1.o
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj -fparallel-codegen=4 -fparallel-codegen-linker %clang %s -o %t.2.o
+// RUN: cmp %t.1.o %t.2.o
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj %s -o %t.serial.o
+// RUN: llvm-nm %t.1.o > %t.parallel.nm
+// RUN: llvm-nm %t.serial.o > %t.serial.nm
+// RUN: diff %t.serial.nm %t.parallel.nm
+// RUN: FileCheck %s < %t.parallel.nm
+
+// Backend errors of a part are reported as diagnostics instead of exiting
+// the worker thread.
+// RUN: not %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj -fparallel-codegen=4 -fparallel-codegen-linker %clang -DBAD_ASM %s -o %t.bad.o 2>&1 | FileCheck --check-prefix=ASM %s
+// ASM: error: {{.*}}invalid instruction mnemonic 'bogus'
+
+// Warnings and remarks of the parts go through the same filters and
+// mappings as those of serial code generation.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj -fparallel-codegen=4 -fparallel-codegen-linker %clang -mllvm -warn-stack-size=0 -Wno-frame-larger-than= %s -o %t.nowarn.o 2>&1 | count 0
+// RUN: not %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj -fparallel-codegen=4 -fparallel-codegen-linker %clang -mllvm -warn-stack-size=0 -Werror=frame-larger-than= %s -o %t.werror.o 2>&1 | FileCheck --check-prefix=STACK %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj -fparallel-codegen=4 -fparallel-codegen-linker %clang -Rpass-analysis=prologepilog %s -o %t.remarks.o 2>&1 | FileCheck --check-prefix=REMARK %s
+// STACK: error: stack frame size of {{[0-9]+}} bytes in function 'first'
+// REMARK-DAG: remark: {{[0-9]+}} stack bytes in function [-Rpass-analysis=prologepilog]
+// REMARK-NOT: warning:
+
+// The parts are only combined for ELF; other targets generate code serially.
+// RUN: %clang_cc1 -triple x86_64-apple-macosx10.13 -O1 -emit-obj -fparallel-codegen=4 -fparallel-codegen-linker %clang %s -o %t.macho.o 2>&1 | FileCheck --check-prefix=NOT-ELF %s
+// NOT-ELF: warning: -fparallel-codegen is not supported for target 'x86_64-apple-macosx10.13{{.*}}'; generating code serially
+
+// CHECK-DAG: D counter
+// CHECK-DAG: T first
+// CHECK-DAG: T second
+// CHECK-DAG: T third
+// CHECK-DAG: T fourth
+// CHECK-DAG: t helper
+
+int counter = 1;
+
+__attribute__((noinline)) static int helper(int x) { return x * 3 + counter; }
+
+int first(int x) { return helper(x) + 1; }
+int second(int x) { return helper(x) * 2; }
+int third(int x) { counter += x; return counter; }
+
+int fourth(int x) {
+#ifdef BAD_ASM
+  __asm__("bogus");
+#endif
+  return x - 1;
+}
@@ -0,0 +1,48 @@
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -debug-info-kind=limited -fuse-ctor-homing -emit-llvm %s -o - | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -debug-info-kind=limited -emit-llvm %s -o - | FileCheck --check-prefix=NOHOMING %s
+// RUN: %clang_cc1 -triple x86_64-windows-msvc -debug-info-kind=limited -fuse-ctor-homing -emit-llvm %s -o - | FileCheck --check-prefix=DLLIMPORT %s
+
+// The constructor is emitted by another translation unit, which describes the
+// class.
+struct Homed {
+  Homed();
+  int i;
+};
+void useHomed(Homed &h) { h.i = 1; }
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Homed"{{.*}}flags: DIFlagFwdDecl
+// NOHOMING-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Homed"{{.*}}elements:
+
+// The constructor is emitted here, so the class is described here.
+struct Constructed {
+  Constructed();
+  int i;
+};
+Constructed::Constructed() : i(0) {}
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Constructed"{{.*}}elements:
+
+// Aggregates can be created without a constructor call.
+struct Aggregate {
+  int i;
+};
+void useAggregate(Aggregate &a) { a.i = 1; }
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Aggregate"{{.*}}elements:
+
+// So can classes with constexpr constructors.
+struct Literal {
+  constexpr Literal() : i(0) {}
+  int i;
+};
+void useLiteral(Literal &l) { l.i = 1; }
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Literal"{{.*}}elements:
+
+#ifdef _WIN32
+// The constructor of a dllimport class is emitted in another DLL, whose
+// type information debuggers do not use, so the class is described here.
+struct __declspec(dllimport) Imported {
+  Imported();
+  int i;
+};
+void useImported(Imported &i) { i.i = 1; }
+// DLLIMPORT-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Imported"{{.*}}elements:
+// DLLIMPORT-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Homed"{{.*}}flags: DIFlagFwdDecl
+#endif
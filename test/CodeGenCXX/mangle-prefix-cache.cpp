@@ -0,0 +1,57 @@
+// RUN: %clang_cc1 -emit-llvm %s -o - -triple=x86_64-linux-gnu | FileCheck %s
+
+// The prefixes shared by several names are mangled once and reused, along
+// with the substitutions they introduce.
+
+namespace outer {
+namespace inner {
+struct S {
+  void f();
+  void g(S);
+  static int x;
+};
+template <typename T> struct Box {
+  void get(T);
+};
+} // namespace inner
+
+struct __attribute__((abi_tag("tag"))) T {
+  void f();
+  void g(T);
+};
+} // namespace outer
+
+// CHECK-DAG: @_ZN5outer5inner1S1xE = {{.*}}global i32 0
+int outer::inner::S::x;
+
+// CHECK-DAG: define {{.*}}void @_ZN5outer5inner1S1fEv(
+void outer::inner::S::f() {}
+
+// CHECK-DAG: define {{.*}}void @_ZN5outer5inner1S1gES1_(
+void outer::inner::S::g(S) {}
+
+// CHECK-DAG: define {{.*}}void @_ZN5outer5inner3BoxIiE3getEi(
+template <> void outer::inner::Box<int>::get(int) {}
+
+// CHECK-DAG: define {{.*}}void @_ZN5outer5inner3BoxINS0_1SEE3getES2_(
+template <> void outer::inner::Box<outer::inner::S>::get(S) {}
+
+// Prefixes with ABI tags are mangled in place.
+// CHECK-DAG: define {{.*}}void @_ZN5outer1TB3tag1fEv(
+void outer::T::f() {}
+
+// CHECK-DAG: define {{.*}}void @_ZN5outer1TB3tag1gES0_(
+void outer::T::g(T) {}
+
+// Prefixes inside functions are mangled in place.
+// CHECK-DAG: define internal {{.*}}void @_ZZN5outer5inner1hEvEN1L1mES1_(
+namespace outer {
+namespace inner {
+void h() {
+  struct L {
+    void m(L) {}
+  };
+  L().m(L());
+}
+} // namespace inner
+} // namespace outer
@@ -0,0 +1,25 @@
+// RUN: %clang_cc1 -triple x86_64-apple-darwin -std=c++11 -emit-llvm -o - %s | FileCheck %s
+
+void predicate_enable(int *List, int Length) {
+  // CHECK-LABEL: define {{.*}} @_Z16predicate_enable
+#pragma clang loop vectorize(enable) vectorize_predicate(enable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_1:.*]]
+    List[i] = i * 2;
+  }
+}
+
+void predicate_disable(int *List, int Length) {
+  // CHECK-LABEL: define {{.*}} @_Z17predicate_disable
+#pragma clang loop vectorize_predicate(disable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_2:.*]]
+    List[i] = i * 2;
+  }
+}
+
+// CHECK: ![[LOOP_1]] = distinct !{![[LOOP_1]], ![[VECTORIZE_ENABLE:.*]], ![[PREDICATE_ENABLE:.*]]}
+// CHECK: ![[VECTORIZE_ENABLE]] = !{!"llvm.loop.vectorize.enable", i1 true}
+// CHECK: ![[PREDICATE_ENABLE]] = !{!"llvm.loop.vectorize.predicate.enable", i1 true}
+// CHECK: ![[LOOP_2]] = distinct !{![[LOOP_2]], ![[PREDICATE_DISABLE:.*]]}
+// CHECK: ![[PREDICATE_DISABLE]] = !{!"llvm.loop.vectorize.predicate.enable", i1 false}
@@ -0,0 +1,14 @@
+// REQUIRES: asserts
+// RUN: %clang_cc1 -fprofile-instrument=clang -fcoverage-mapping -emit-llvm-only -main-file-name stats.cpp %s -stats-file=%t.stats
+// RUN: FileCheck -input-file=%t.stats %s
+
+// Both the used and the unused function get a record.
+// CHECK-DAG: "coverage-mapping.NumFunctionRecords": 2
+// CHECK-DAG: "coverage-mapping.FilenamesBytes":
+// CHECK-DAG: "coverage-mapping.MappingBytes":
+
+inline int unused(int x) { return x ? 1 : 2; }
+
+int main() {
+  return 0;
+}
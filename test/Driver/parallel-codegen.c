@@ -0,0 +1,13 @@
+// RUN: %clang -### -c -fparallel-codegen=4 %s 2>&1 | FileCheck %s
+// CHECK: "-cc1"
+// CHECK-SAME: "-fparallel-codegen=4"
+// CHECK-SAME: "-fparallel-codegen-linker" "{{[^"]*}}clang{{[^"]*}}"
+
+// RUN: %clang -### -c %s 2>&1 | FileCheck --check-prefix=NONE %s
+// NONE-NOT: -fparallel-codegen
+
+// RUN: not %clang_cc1 -fparallel-codegen=0 -emit-obj %s -o /dev/null 2>&1 | FileCheck --check-prefix=ZERO %s
+// ZERO: invalid value '0' in '-fparallel-codegen=0'
+
+// RUN: not %clang_cc1 -fparallel-codegen=-1 -emit-obj %s -o /dev/null 2>&1 | FileCheck --check-prefix=NEGATIVE %s
+// NEGATIVE: invalid value '-1' in '-fparallel-codegen=-1'
@@ -39,6 +39,17 @@ void test(int *List, int Length) {
     List[i] = i * 2;
     i++;
   }
+
+// CHECK: #pragma clang loop vectorize_predicate(enable)
+// CHECK-NEXT: #pragma clang loop unroll_and_jam_count(2)
+
+#pragma clang loop vectorize_predicate(enable)
+#pragma clang loop unroll_and_jam_count(2)
+// CHECK-NEXT: while (i - 3 < Length)
+  while (i - 3 < Length) {
+    List[i] = i * 2;
+    i++;
+  }
 }
 
 template <int V, int I>
@@ -0,0 +1 @@
+#include "textual.h"
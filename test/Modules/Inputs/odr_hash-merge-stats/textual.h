@@ -0,0 +1,9 @@
+#ifndef TEXTUAL_H
+#define TEXTUAL_H
+struct S {
+  int get();
+  int x;
+};
+inline int S::get() { return x; }
+enum E { E1, E2 };
+#endif
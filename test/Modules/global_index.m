@@ -7,12 +7,26 @@
 // RUN: ls %t|grep modules.idx
 // Run and use the global module index
 // RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -print-stats 2>&1 | FileCheck %s
+// Add a module to the cache and incrementally update the global module index
+// RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DIMPORT_CMDLINE
+// RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DIMPORT_CMDLINE -print-stats 2>&1 | FileCheck %s
+// The identifier lookups hit and miss as with an index built from scratch
+// RUN: rm -rf %t-full
+// RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t-full -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DIMPORT_CMDLINE
+// RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t-full -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DIMPORT_CMDLINE -print-stats 2>&1 | grep "identifier lookups" > %t-full.stats
+// RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DIMPORT_CMDLINE -print-stats 2>&1 | grep "identifier lookups" > %t-incremental.stats
+// RUN: FileCheck --check-prefix=LOOKUPS %s < %t-full.stats
+// RUN: diff %t-full.stats %t-incremental.stats
 
 // expected-no-diagnostics
 @import DependsOnModule;
 @import Module;
+#ifdef IMPORT_CMDLINE
+@import CmdLine;
+#endif
 
 // CHECK: *** Global Module Index Statistics:
+// LOOKUPS: identifier lookups succeeded
 
 int *get_sub() {
   return Module_Sub;
@@ -0,0 +1,21 @@
+// Rebuilding the global module index only loads the module files that
+// changed since the previous index was written.
+
+// REQUIRES: asserts
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify
+// RUN: ls %t | grep modules.idx
+// Add a module to the cache, which updates the global module index
+// RUN: %clang_cc1 -Wauto-import -Wno-private-module -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DIMPORT_CMDLINE -stats-file=%t.stats
+// RUN: FileCheck -input-file=%t.stats %s
+
+// Only the new module file is loaded; the others come from the old index.
+// CHECK-DAG: "globalmoduleindex.NumModuleFilesLoaded": 1
+// CHECK-DAG: "globalmoduleindex.NumModuleFilesReused": {{[1-9][0-9]*}}
+
+// expected-no-diagnostics
+@import DependsOnModule;
+@import Module;
+#ifdef IMPORT_CMDLINE
+@import CmdLine;
+#endif
@@ -0,0 +1,19 @@
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t \
+// RUN:   -I %S/Inputs/odr_hash-merge-stats -x c++ -std=c++11 %s -verify \
+// RUN:   -print-stats 2>&1 | FileCheck %s
+
+// Identical definitions of S, S::get and E from the two modules are merged
+// using their ODR hashes, and the members of the second definition of S are
+// not checked individually against the first.
+
+#include "a.h"
+#include "b.h"
+
+int use(S s) { return s.get() + s.x + E2; }
+
+// expected-no-diagnostics
+
+// CHECK: *** AST File Statistics:
+// CHECK: {{[1-9][0-9]*}} definitions merged by ODR hash
+// CHECK: {{[1-9][0-9]*}} ODR merge checks skipped by ODR hash
@@ -66,8 +66,24 @@ void test(int *List, int Length, int Value) {
     }
   }
 
-// pragma clang unroll_and_jam is disabled for the moment
-/* expected-error {{invalid option 'unroll_and_jam'; expected vectorize, vectorize_width, interleave, interleave_count, unroll, unroll_count, or distribute}} */ #pragma clang loop unroll_and_jam(4)
+#pragma clang loop unroll_and_jam(enable)
+  for (int i = 0; i < Length; i++) {
+    for (int j = 0; j < Length; j++) {
+      List[i * Length + j] = Value;
+    }
+  }
+
+#pragma clang loop unroll_and_jam_count(4)
+  for (int i = 0; i < Length; i++) {
+    for (int j = 0; j < Length; j++) {
+      List[i * Length + j] = Value;
+    }
+  }
+
+/* expected-error {{invalid argument; expected 'enable', 'full' or 'disable'}} */ #pragma clang loop unroll_and_jam(4)
+/* expected-error {{missing argument; expected an integer value}} */ #pragma clang loop unroll_and_jam_count()
+#pragma clang loop unroll_and_jam_count(4)
+/* expected-error {{incompatible directives 'unroll_and_jam(disable)' and 'unroll_and_jam_count(4)'}} */ #pragma clang loop unroll_and_jam(disable)
   for (int i = 0; i < Length; i++) {
     for (int j = 0; j < Length; j++) {
       List[i * Length + j] = Value;
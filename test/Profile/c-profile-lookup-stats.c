@@ -0,0 +1,12 @@
+// Test the statistics about looking up functions in the profile.
+
+// REQUIRES: asserts
+// RUN: llvm-profdata merge %S/Inputs/c-outdated-data.proftext -o %t.profdata
+// RUN: %clang_cc1 -triple x86_64-apple-macosx10.9 -main-file-name c-outdated-data.c %S/c-outdated-data.c -o /dev/null -emit-llvm -fprofile-instrument-use-path=%t.profdata -stats-file=%t.stats
+// RUN: FileCheck -input-file=%t.stats %s
+
+// Every function is looked up, but only main has a record with a matching
+// hash.
+// CHECK-DAG: "codegenpgo.NumProfileLookups": 3
+// CHECK-DAG: "codegenpgo.NumProfileRecordsUsed": 1
+// CHECK-DAG: "codegenpgo.ProfileLookupMicroseconds":
@@ -174,6 +174,13 @@ llvm_config.feature_config(
 if lit.util.which('xmllint'):
     config.available_features.add('xmllint')
 
+# A linker that combines x86_64 Linux objects, for the partial link that
+# -fparallel-codegen runs through the clang driver.
+if (platform.system() == 'Linux' and
+        re.match(r'^x86_64.*-linux', config.host_triple) and
+        lit.util.which('ld')):
+    config.available_features.add('system-linker')
+
 if config.enable_backtrace:
     config.available_features.add('backtrace')
 
@@ -17,6 +17,7 @@
 
 #include "clang-c/Index.h"
 #include "clang/Frontend/PCHContainerOperations.h"
+#include "clang/Frontend/PreambleStore.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Mutex.h"
 #include <utility>
@@ -41,6 +42,10 @@ class CIndexer {
   std::string ResourcesPath;
   std::shared_ptr<PCHContainerOperations> PCHContainerOps;
 
+  /// Preambles shared by translation units parsed with
+  /// CXTranslationUnit_SharePreamble.
+  std::shared_ptr<PreambleStore> SharedPreambles;
+
   std::string ToolchainPath;
 
   std::string InvocationEmissionPath;
@@ -49,8 +54,8 @@ public:
   CIndexer(std::shared_ptr<PCHContainerOperations> PCHContainerOps =
                std::make_shared<PCHContainerOperations>())
       : OnlyLocalDecls(false), DisplayDiagnostics(false),
-        Options(CXGlobalOpt_None), PCHContainerOps(std::move(PCHContainerOps)) {
-  }
+        Options(CXGlobalOpt_None), PCHContainerOps(std::move(PCHContainerOps)),
+        SharedPreambles(std::make_shared<PreambleStore>()) {}
 
   /// Whether we only want to see "local" declarations (that did not
   /// come from a previous precompiled header). If false, we want to see all
@@ -67,6 +72,10 @@ public:
     return PCHContainerOps;
   }
 
+  std::shared_ptr<PreambleStore> getPreambleStore() const {
+    return SharedPreambles;
+  }
+
   unsigned getCXGlobalOptFlags() const { return Options; }
   void setCXGlobalOptFlags(unsigned options) { Options = options; }
 
@@ -0,0 +1,113 @@
+//===- SharedModuleCacheTest.cpp - SharedModuleCache tests ----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/SharedModuleCache.h"
+#include "clang/Basic/MemoryBufferCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+std::shared_ptr<MemoryBuffer> getBuffer(int I, size_t Size = 8) {
+  std::string Bytes(Size, 'a' + I);
+  return MemoryBuffer::getMemBufferCopy(Bytes, "");
+}
+
+TEST(SharedModuleCacheTest, lookupBuffer) {
+  SharedModuleCache Cache;
+  auto B1 = getBuffer(1);
+  Cache.addBuffer("1", /*Size=*/10, /*ModTime=*/100, B1);
+
+  time_t ValidationTime = 42;
+  EXPECT_EQ(B1, Cache.lookupBuffer("1", 10, 100, &ValidationTime));
+  EXPECT_EQ(0, ValidationTime);
+
+  // The file changed on disk.
+  EXPECT_EQ(nullptr, Cache.lookupBuffer("1", 11, 100));
+  EXPECT_EQ(nullptr, Cache.lookupBuffer("1", 10, 101));
+  EXPECT_EQ(nullptr, Cache.lookupBuffer("2", 10, 100));
+
+  Cache.markValidated("1", 200);
+  EXPECT_EQ(B1, Cache.lookupBuffer("1", 10, 100, &ValidationTime));
+  EXPECT_EQ(200, ValidationTime);
+
+  // Replacing the buffer forgets that it was validated.
+  auto B2 = getBuffer(2);
+  Cache.addBuffer("1", 10, 101, B2);
+  EXPECT_EQ(nullptr, Cache.lookupBuffer("1", 10, 100));
+  EXPECT_EQ(B2, Cache.lookupBuffer("1", 10, 101, &ValidationTime));
+  EXPECT_EQ(0, ValidationTime);
+
+  // Only the buffer that is still cached can be removed.
+  Cache.removeBuffer("1", B1.get());
+  EXPECT_EQ(B2, Cache.lookupBuffer("1", 10, 101));
+
+  // Users keep removed buffers alive.
+  Cache.removeBuffer("1", B2.get());
+  EXPECT_EQ(nullptr, Cache.lookupBuffer("1", 10, 101));
+  EXPECT_EQ(0u, Cache.getTotalSize());
+  EXPECT_EQ(8u, B2->getBufferSize());
+}
+
+TEST(SharedModuleCacheTest, evictLeastRecentlyUsed) {
+  SharedModuleCache Cache(/*MemoryBudget=*/30);
+  Cache.addBuffer("1", 10, 0, getBuffer(1, 10));
+  Cache.addBuffer("2", 10, 0, getBuffer(2, 10));
+  Cache.addBuffer("3", 10, 0, getBuffer(3, 10));
+  EXPECT_EQ(30u, Cache.getTotalSize());
+
+  // Touch "1", so that "2" is the least recently used buffer.
+  EXPECT_NE(nullptr, Cache.lookupBuffer("1", 10, 0));
+  Cache.addBuffer("4", 10, 0, getBuffer(4, 10));
+  EXPECT_EQ(30u, Cache.getTotalSize());
+  EXPECT_NE(nullptr, Cache.lookupBuffer("1", 10, 0));
+  EXPECT_EQ(nullptr, Cache.lookupBuffer("2", 10, 0));
+  EXPECT_NE(nullptr, Cache.lookupBuffer("3", 10, 0));
+  EXPECT_NE(nullptr, Cache.lookupBuffer("4", 10, 0));
+
+  // Shrinking the budget evicts more.
+  Cache.setMemoryBudget(15);
+  EXPECT_EQ(10u, Cache.getTotalSize());
+  EXPECT_NE(nullptr, Cache.lookupBuffer("4", 10, 0));
+}
+
+TEST(SharedModuleCacheTest, removeFromMemoryBufferCache) {
+  IntrusiveRefCntPtr<SharedModuleCache> Shared(new SharedModuleCache);
+  auto B1 = getBuffer(1);
+  Shared->addBuffer("1", 8, 0, B1);
+
+  MemoryBufferCache Cache;
+  Cache.setSharedCache(Shared);
+  EXPECT_EQ(B1.get(), &Cache.addBuffer("1", B1));
+
+  // A buffer found to be out of date is dropped from the shared cache too.
+  EXPECT_FALSE(Cache.tryToRemoveBuffer("1"));
+  EXPECT_EQ(nullptr, Shared->lookupBuffer("1", 8, 0));
+}
+
+TEST(SharedModuleCacheTest, keepReplacedBufferOnRemove) {
+  IntrusiveRefCntPtr<SharedModuleCache> Shared(new SharedModuleCache);
+  auto B1 = getBuffer(1);
+  MemoryBufferCache Cache;
+  Cache.setSharedCache(Shared);
+  Cache.addBuffer("1", B1);
+
+  // Another compilation read the module file again after it was rebuilt.
+  auto B2 = getBuffer(2);
+  Shared->addBuffer("1", 8, 1, B2);
+
+  // Dropping the old buffer leaves the new one in the shared cache.
+  EXPECT_FALSE(Cache.tryToRemoveBuffer("1"));
+  EXPECT_EQ(B2, Shared->lookupBuffer("1", 8, 1));
+}
+
+} // namespace
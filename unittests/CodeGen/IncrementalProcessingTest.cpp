@@ -171,4 +171,72 @@ TEST(IncrementalProcessing, EmitCXXGlobalInitFunc) {
 
 }
 
+// Records laid out for one module are reused by the following ones instead of
+// being converted again under a new name.
+const char RecordProgram1[] =
+    "struct Point { int x, y; };\n"
+    "extern \"C\" int getX(Point *P) { return P->x; }";
+
+const char RecordProgram2[] =
+    "extern \"C\" int getY(Point *P) { return P->y; }";
+
+TEST(IncrementalProcessing, ReuseRecordLayouts) {
+    LLVMContext Context;
+    CompilerInstance compiler;
+
+    compiler.createDiagnostics();
+    compiler.getLangOpts().CPlusPlus = 1;
+    compiler.getLangOpts().CPlusPlus11 = 1;
+
+    compiler.getTargetOpts().Triple = llvm::Triple::normalize(
+        llvm::sys::getProcessTriple());
+    compiler.setTarget(clang::TargetInfo::CreateTargetInfo(
+      compiler.getDiagnostics(),
+      std::make_shared<clang::TargetOptions>(
+        compiler.getTargetOpts())));
+
+    compiler.createFileManager();
+    compiler.createSourceManager(compiler.getFileManager());
+    compiler.createPreprocessor(clang::TU_Prefix);
+    compiler.getPreprocessor().enableIncrementalProcessing();
+
+    compiler.createASTContext();
+
+    CodeGenerator* CG =
+        CreateLLVMCodeGen(
+            compiler.getDiagnostics(),
+            "main-module",
+            compiler.getHeaderSearchOpts(),
+            compiler.getPreprocessorOpts(),
+            compiler.getCodeGenOpts(),
+            Context);
+    compiler.setASTConsumer(std::unique_ptr<ASTConsumer>(CG));
+    compiler.createSema(clang::TU_Prefix, nullptr);
+    Sema& S = compiler.getSema();
+
+    std::unique_ptr<Parser> ParseOP(new Parser(S.getPreprocessor(), S,
+                                               /*SkipFunctionBodies*/ false));
+    Parser &P = *ParseOP.get();
+
+    std::array<std::unique_ptr<llvm::Module>, 3> M;
+    M[0] = IncrementalParseAST(compiler, P, *CG, nullptr);
+    ASSERT_TRUE(M[0]);
+
+    M[1] = IncrementalParseAST(compiler, P, *CG, RecordProgram1);
+    ASSERT_TRUE(M[1]);
+    const Function *GetX = M[1]->getFunction("getX");
+    ASSERT_TRUE(GetX);
+
+    M[2] = IncrementalParseAST(compiler, P, *CG, RecordProgram2);
+    ASSERT_TRUE(M[2]);
+    const Function *GetY = M[2]->getFunction("getY");
+    ASSERT_TRUE(GetY);
+
+    // Both modules use the same LLVM type for the record.
+    llvm::Type *PointTy = GetX->getFunctionType()->getParamType(0);
+    ASSERT_EQ(PointTy, GetY->getFunctionType()->getParamType(0));
+    ASSERT_EQ("struct.Point",
+              PointTy->getPointerElementType()->getStructName());
+}
+
 } // end anonymous namespace
@@ -98,6 +98,111 @@ private:
   bool *Success;
 };
 
+/// Saves the AST of \p SourceText to a temporary file and returns its name.
+/// The source file is kept alive by \p Files, since the AST refers to it.
+std::string
+createASTFile(StringRef SourceText,
+              std::vector<std::unique_ptr<llvm::ToolOutputFile>> &Files) {
+  int SourceFD;
+  llvm::SmallString<256> SourceFileName;
+  EXPECT_FALSE(llvm::sys::fs::createTemporaryFile("input", "cpp", SourceFD,
+                                                  SourceFileName));
+  Files.push_back(
+      llvm::make_unique<llvm::ToolOutputFile>(SourceFileName, SourceFD));
+  Files.back()->os() << SourceText;
+  Files.back()->os().flush();
+
+  int ASTFD;
+  llvm::SmallString<256> ASTFileName;
+  EXPECT_FALSE(
+      llvm::sys::fs::createTemporaryFile("ast", "ast", ASTFD, ASTFileName));
+  Files.push_back(llvm::make_unique<llvm::ToolOutputFile>(ASTFileName, ASTFD));
+  std::unique_ptr<ASTUnit> Unit =
+      tooling::buildASTFromCode(SourceText, SourceFileName);
+  Unit->Save(ASTFileName.str());
+  return ASTFileName.str();
+}
+
+class CTUBudgetASTConsumer : public clang::ASTConsumer {
+public:
+  explicit CTUBudgetASTConsumer(clang::CompilerInstance &CI, bool *Success)
+      : CTU(CI), Success(Success) {}
+
+  void HandleTranslationUnit(ASTContext &Ctx) {
+    const FunctionDecl *FD = nullptr, *HD = nullptr;
+    for (const Decl *D : Ctx.getTranslationUnitDecl()->decls()) {
+      if (const auto *Function = dyn_cast<FunctionDecl>(D)) {
+        if (Function->getName() == "f")
+          FD = Function;
+        else if (Function->getName() == "h")
+          HD = Function;
+      }
+    }
+    ASSERT_TRUE(FD && HD);
+
+    std::vector<std::unique_ptr<llvm::ToolOutputFile>> Files;
+    std::string FAST = createASTFile("int f(int) { return 0; }\n", Files);
+    std::string GAST = createASTFile("int g(int) { return 1; }\n", Files);
+    std::string HAST = createASTFile(
+        "__attribute__((noinline)) int h(int) { return 2; }\n", Files);
+    int IndexFD;
+    llvm::SmallString<256> IndexFileName;
+    ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("index", "txt", IndexFD,
+                                                    IndexFileName));
+    llvm::ToolOutputFile IndexFile(IndexFileName, IndexFD);
+    IndexFile.os() << "c:@F@f#I# " << FAST << "\n"
+                   << "c:@F@g#I# " << GAST << "\n"
+                   << "c:@F@h#I# " << HAST << "\n";
+    IndexFile.os().flush();
+
+    // Every AST exceeds a one byte budget, so loading one unloads the others.
+    CTU.setASTMemoryBudget(1);
+    llvm::Expected<ASTUnit *> GUnit =
+        CTU.loadExternalAST("c:@F@g#I#", "", IndexFileName);
+    ASSERT_TRUE(GUnit && *GUnit);
+    EXPECT_EQ(1u, CTU.getNumLoadedASTs());
+
+    // The imported definition of f does not refer to its AST, so the AST is
+    // unloaded when the next one is loaded.
+    llvm::Expected<const FunctionDecl *> NewFD =
+        CTU.getCrossTUDefinition(FD, "", IndexFileName);
+    ASSERT_TRUE(NewFD && *NewFD);
+    EXPECT_EQ(1u, CTU.getNumLoadedASTs());
+    GUnit = CTU.loadExternalAST("c:@F@g#I#", "", IndexFileName);
+    ASSERT_TRUE(GUnit && *GUnit);
+    EXPECT_EQ(1u, CTU.getNumLoadedASTs());
+
+    // The attributes of the imported definition of h refer to its AST, so the
+    // AST stays loaded.
+    llvm::Expected<const FunctionDecl *> NewHD =
+        CTU.getCrossTUDefinition(HD, "", IndexFileName);
+    ASSERT_TRUE(NewHD && *NewHD);
+    GUnit = CTU.loadExternalAST("c:@F@g#I#", "", IndexFileName);
+    ASSERT_TRUE(GUnit && *GUnit);
+    EXPECT_EQ(2u, CTU.getNumLoadedASTs());
+
+    *Success = (*NewFD)->hasBody() && (*NewHD)->hasBody();
+  }
+
+private:
+  CrossTranslationUnitContext CTU;
+  bool *Success;
+};
+
+class CTUBudgetAction : public clang::ASTFrontendAction {
+public:
+  CTUBudgetAction(bool *Success) : Success(Success) {}
+
+protected:
+  std::unique_ptr<clang::ASTConsumer>
+  CreateASTConsumer(clang::CompilerInstance &CI, StringRef) override {
+    return llvm::make_unique<CTUBudgetASTConsumer>(CI, Success);
+  }
+
+private:
+  bool *Success;
+};
+
 } // end namespace
 
 TEST(CrossTranslationUnit, CanLoadFunctionDefinition) {
@@ -106,6 +211,14 @@ TEST(CrossTranslationUnit, CanLoadFunctionDefinition) {
   EXPECT_TRUE(Success);
 }
 
+TEST(CrossTranslationUnit, UnloadsASTsOverBudget) {
+  bool Success = false;
+  EXPECT_TRUE(
+      tooling::runToolOnCode(new CTUBudgetAction(&Success),
+                             "int f(int);\nint h(int);"));
+  EXPECT_TRUE(Success);
+}
+
 TEST(CrossTranslationUnit, IndexFormatCanBeParsed) {
   llvm::StringMap<std::string> Index;
   Index["a"] = "/b/f1";
@@ -153,5 +266,39 @@ TEST(CrossTranslationUnit, CTUDirIsHandledCorrectly) {
   EXPECT_EQ(ParsedIndex["a"], "/ctudir/b/c/d");
 }
 
+TEST(CrossTranslationUnit, IndexErrorsAreReported) {
+  auto ParseIndex = [](StringRef IndexText) {
+    int IndexFD;
+    llvm::SmallString<256> IndexFileName;
+    EXPECT_FALSE(llvm::sys::fs::createTemporaryFile("index", "txt", IndexFD,
+                                                    IndexFileName));
+    llvm::ToolOutputFile IndexFile(IndexFileName, IndexFD);
+    IndexFile.os() << IndexText;
+    IndexFile.os().flush();
+    return parseCrossTUIndex(IndexFileName, "");
+  };
+
+  auto ExpectError = [](llvm::Expected<llvm::StringMap<std::string>> IndexOrErr,
+                        index_error_code Code, int LineNo) {
+    ASSERT_FALSE((bool)IndexOrErr);
+    llvm::handleAllErrors(IndexOrErr.takeError(), [&](const IndexError &IE) {
+      EXPECT_EQ(Code, IE.getCode());
+      EXPECT_EQ(LineNo, IE.getLineNum());
+    });
+  };
+
+  ExpectError(ParseIndex("a /b\nmalformed\n"),
+              index_error_code::invalid_index_format, 2);
+  ExpectError(ParseIndex("a /b\nc /d\na /e\n"),
+              index_error_code::multiple_definitions, 3);
+
+  // The last line does not need to be terminated.
+  llvm::Expected<llvm::StringMap<std::string>> IndexOrErr =
+      ParseIndex("a /b\nc /d");
+  ASSERT_TRUE((bool)IndexOrErr);
+  EXPECT_EQ(2u, IndexOrErr->size());
+  EXPECT_EQ("/d", (*IndexOrErr)["c"]);
+}
+
 } // end namespace cross_tu
 } // end namespace clang
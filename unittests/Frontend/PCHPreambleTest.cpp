@@ -12,10 +12,15 @@
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Frontend/FrontendOptions.h"
+#include "clang/Frontend/PCHContainerOperations.h"
+#include "clang/Frontend/PreambleStore.h"
+#include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/FileManager.h"
+#include "clang/Serialization/ASTReader.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "gtest/gtest.h"
@@ -77,8 +82,8 @@ public:
     RemappedFiles[Filename] = Contents;
   }
 
-  std::unique_ptr<ASTUnit> ParseAST(const std::string &EntryFile) {
-    PCHContainerOpts = std::make_shared<PCHContainerOperations>();
+  std::shared_ptr<CompilerInvocation>
+  CreateInvocation(const std::string &EntryFile) {
     std::shared_ptr<CompilerInvocation> CI(new CompilerInvocation);
     CI->getFrontendOpts().Inputs.push_back(
       FrontendInputFile(EntryFile, FrontendOptions::getInputKindForExtension(
@@ -90,6 +95,12 @@ public:
 
     PreprocessorOptions &PPOpts = CI->getPreprocessorOpts();
     PPOpts.RemappedFilesKeepOriginalName = true;
+    return CI;
+  }
+
+  std::unique_ptr<ASTUnit> ParseAST(const std::string &EntryFile) {
+    PCHContainerOpts = std::make_shared<PCHContainerOperations>();
+    std::shared_ptr<CompilerInvocation> CI = CreateInvocation(EntryFile);
 
     IntrusiveRefCntPtr<DiagnosticsEngine>
       Diags(CompilerInstance::createDiagnostics(new DiagnosticOptions, new DiagnosticConsumer));
@@ -107,10 +118,89 @@ public:
     return !reparseFailed;
   }
 
+  /// Parses \p EntryFile, then reparses it to build its preamble through
+  /// \p Store.
+  std::unique_ptr<ASTUnit>
+  ParseASTWithPreambleStore(const std::string &EntryFile,
+                            std::shared_ptr<PreambleStore> Store) {
+    PCHContainerOpts = std::make_shared<PCHContainerOperations>();
+    std::shared_ptr<CompilerInvocation> CI = CreateInvocation(EntryFile);
+
+    IntrusiveRefCntPtr<DiagnosticsEngine>
+      Diags(CompilerInstance::createDiagnostics(new DiagnosticOptions, new DiagnosticConsumer));
+
+    FileManager *FileMgr = new FileManager(FSOpts, VFS);
+
+    std::unique_ptr<ASTUnit> AST = ASTUnit::LoadFromCompilerInvocation(
+      CI, PCHContainerOpts, Diags, FileMgr, false, false,
+      /*PrecompilePreambleAfterNParses=*/2);
+    if (!AST)
+      return nullptr;
+    AST->setPreambleStore(std::move(Store));
+    if (!ReparseAST(AST))
+      return nullptr;
+    return AST;
+  }
+
   unsigned GetFileReadCount(const std::string &Filename) const {
     return VFS->GetReadCount(Filename);
   }
 
+  /// Builds an in-memory preamble for \p MainFile with the contents
+  /// \p Contents, as an extension of \p Base if it is given.
+  llvm::ErrorOr<PrecompiledPreamble>
+  BuildPreamble(const std::string &MainFile, const std::string &Contents,
+                std::shared_ptr<const PrecompiledPreamble> Base = nullptr) {
+    std::shared_ptr<CompilerInvocation> CI = CreateInvocation(MainFile);
+    std::unique_ptr<MemoryBuffer> Buffer =
+        MemoryBuffer::getMemBufferCopy(Contents, MainFile);
+    PreambleBounds Bounds =
+        ComputePreambleBounds(*CI->getLangOpts(), Buffer.get(), 0);
+    IntrusiveRefCntPtr<DiagnosticsEngine> Diags(
+        CompilerInstance::createDiagnostics(new DiagnosticOptions,
+                                            new DiagnosticConsumer));
+    PreambleCallbacks Callbacks;
+    auto PCHContainerOps = std::make_shared<PCHContainerOperations>();
+    if (Base)
+      return PrecompiledPreamble::BuildExtension(
+          std::move(Base), *CI, Buffer.get(), Bounds, *Diags, VFS,
+          PCHContainerOps, /*StoreInMemory=*/true, Callbacks);
+    return PrecompiledPreamble::Build(*CI, Buffer.get(), Bounds, *Diags, VFS,
+                                      PCHContainerOps, /*StoreInMemory=*/true,
+                                      Callbacks);
+  }
+
+  /// Parses \p MainFile with the contents \p Contents on top of \p Preamble
+  /// and returns whether that succeeded without errors.
+  bool ParseWithPreamble(const PrecompiledPreamble &Preamble,
+                         const std::string &MainFile,
+                         const std::string &Contents) {
+    std::shared_ptr<CompilerInvocation> CI = CreateInvocation(MainFile);
+    IntrusiveRefCntPtr<vfs::FileSystem> PreambleVFS = VFS;
+    // The compiler instance takes over the main file buffer.
+    Preamble.AddImplicitPreamble(
+        *CI, PreambleVFS,
+        MemoryBuffer::getMemBufferCopy(Contents, MainFile).release());
+
+    CompilerInstance Clang;
+    Clang.setInvocation(std::move(CI));
+    Clang.createDiagnostics(new DiagnosticConsumer);
+    Clang.setFileManager(new FileManager(FSOpts, PreambleVFS));
+    SyntaxOnlyAction Action;
+    return Clang.ExecuteAction(Action) &&
+           !Clang.getDiagnostics().hasErrorOccurred();
+  }
+
+  bool CanExtend(const PrecompiledPreamble &Preamble,
+                 const std::string &MainFile, const std::string &Contents) {
+    std::shared_ptr<CompilerInvocation> CI = CreateInvocation(MainFile);
+    std::unique_ptr<MemoryBuffer> Buffer =
+        MemoryBuffer::getMemBufferCopy(Contents, MainFile);
+    PreambleBounds Bounds =
+        ComputePreambleBounds(*CI->getLangOpts(), Buffer.get(), 0);
+    return Preamble.CanExtend(*CI, Buffer.get(), Bounds, VFS.get());
+  }
+
 private:
   std::vector<std::pair<std::string, llvm::MemoryBuffer *>>
   GetRemappedFiles() const {
@@ -197,4 +287,169 @@ TEST_F(PCHPreambleTest, ParseWithBom) {
   ASSERT_LE(HeaderReadCount, GetFileReadCount(Header));
 }
 
+TEST_F(PCHPreambleTest, ExtendPreamble) {
+  std::string Header1 = "//./header1.h";
+  std::string Header2 = "//./header2.h";
+  std::string Main = "//./main.cpp";
+  AddFile(Header1, "int a;\n");
+  AddFile(Header2, "int b;\n");
+  std::string Contents = "#include \"//./header1.h\"\n"
+                         "int main() { return a; }";
+  std::string Extended = "#include \"//./header1.h\"\n"
+                         "#include \"//./header2.h\"\n"
+                         "int main() { return a + b; }";
+  std::string Reordered = "#include \"//./header2.h\"\n"
+                          "#include \"//./header1.h\"\n"
+                          "int main() { return a + b; }";
+  AddFile(Main, Contents);
+
+  llvm::ErrorOr<PrecompiledPreamble> BaseOrErr = BuildPreamble(Main, Contents);
+  ASSERT_TRUE(BaseOrErr);
+  auto Base = std::make_shared<PrecompiledPreamble>(std::move(*BaseOrErr));
+
+  // The new preamble must start with the whole old one.
+  EXPECT_TRUE(CanExtend(*Base, Main, Extended));
+  EXPECT_FALSE(CanExtend(*Base, Main, Contents));
+  EXPECT_FALSE(CanExtend(*Base, Main, Reordered));
+
+  llvm::ErrorOr<PrecompiledPreamble> ExtensionOrErr =
+      BuildPreamble(Main, Extended, Base);
+  ASSERT_TRUE(ExtensionOrErr);
+  EXPECT_EQ(Extended.find("int main"), ExtensionOrErr->getBounds().Size);
+  EXPECT_LT(Base->getBounds().Size, ExtensionOrErr->getBounds().Size);
+
+  llvm::ErrorOr<PrecompiledPreamble> RejectedOrErr =
+      BuildPreamble(Main, Reordered, Base);
+  EXPECT_EQ(make_error_code(BuildPreambleError::BaseCannotBeExtended),
+            RejectedOrErr.getError());
+}
+
+TEST_F(PCHPreambleTest, WritePreambleToFile) {
+  std::string Header1 = "//./header1.h";
+  std::string Header2 = "//./header2.h";
+  std::string Main = "//./main.cpp";
+  AddFile(Header1, "int a;\n");
+  AddFile(Header2, "int b;\n");
+  std::string Contents = "#include \"//./header1.h\"\n"
+                         "int main() { return a; }";
+  std::string Extended = "#include \"//./header1.h\"\n"
+                         "#include \"//./header2.h\"\n"
+                         "int main() { return a + b; }";
+  AddFile(Main, Contents);
+
+  llvm::ErrorOr<PrecompiledPreamble> BaseOrErr = BuildPreamble(Main, Contents);
+  ASSERT_TRUE(BaseOrErr);
+  auto Base = std::make_shared<PrecompiledPreamble>(std::move(*BaseOrErr));
+
+  SmallString<128> Path;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("preamble", "pch", Path));
+  FileRemover RemovePath(Path);
+  ASSERT_FALSE(Base->WriteToFile(Path));
+
+  // The written file is the PCH of the preamble, readable on its own.
+  uint64_t FileSize;
+  ASSERT_FALSE(sys::fs::file_size(Path, FileSize));
+  EXPECT_EQ(Base->getSize(), FileSize);
+  FileSystemOptions FSOpts;
+  FileManager FileMgr(FSOpts);
+  PCHContainerOperations PCHContainerOps;
+  IntrusiveRefCntPtr<DiagnosticsEngine> Diags(
+      CompilerInstance::createDiagnostics(new DiagnosticOptions,
+                                          new DiagnosticConsumer));
+  std::string OriginalFile = ASTReader::getOriginalSourceFile(
+      Path.str(), FileMgr, PCHContainerOps.getRawReader(), *Diags);
+  EXPECT_TRUE(StringRef(OriginalFile).endswith("main.cpp"));
+
+  // Extensions depend on the PCH of their base.
+  llvm::ErrorOr<PrecompiledPreamble> Extension =
+      BuildPreamble(Main, Extended, Base);
+  ASSERT_TRUE(Extension);
+  EXPECT_EQ(std::make_error_code(std::errc::not_supported),
+            Extension->WriteToFile(Path));
+}
+
+TEST_F(PCHPreambleTest, ParseWithInMemoryPreamble) {
+  std::string Header = "//./header.h";
+  std::string Main = "//./main.cpp";
+  AddFile(Header, "int a;\n");
+  std::string Contents = "#include \"//./header.h\"\n"
+                         "int main() { return a; }";
+  AddFile(Main, Contents);
+
+  // The PCH of an in-memory preamble is read through buffers that must be
+  // null-terminated.
+  llvm::ErrorOr<PrecompiledPreamble> Preamble = BuildPreamble(Main, Contents);
+  ASSERT_TRUE(Preamble);
+  EXPECT_TRUE(ParseWithPreamble(*Preamble, Main, Contents));
+  EXPECT_TRUE(ParseWithPreamble(*Preamble, Main, Contents));
+}
+
+TEST_F(PCHPreambleTest, SharePreambleBetweenMainFiles) {
+  std::string Header1 = "//./header1.h";
+  std::string Header2 = "//./header2.h";
+  std::string First = "//./first.cpp";
+  std::string Second = "//./second.cpp";
+  std::string Third = "//./third.cpp";
+  AddFile(Header1, "int a;\n");
+  AddFile(Header2, "int b;\n");
+  AddFile(First, "#include \"//./header1.h\"\n"
+                 "int first() { return a; }");
+  AddFile(Second, "#include \"//./header1.h\"\n"
+                  "int second() { return a; }");
+  // The preamble of this file starts with the one of the other files.
+  AddFile(Third, "#include \"//./header1.h\"\n"
+                 "#include \"//./header2.h\"\n"
+                 "int third() { return a + b; }");
+
+  auto Store = std::make_shared<PreambleStore>();
+  std::unique_ptr<ASTUnit> FirstAST = ParseASTWithPreambleStore(First, Store);
+  ASSERT_TRUE(FirstAST.get());
+  ASSERT_FALSE(FirstAST->getDiagnostics().hasErrorOccurred());
+  EXPECT_EQ(0U, Store->getNumReused());
+  EXPECT_EQ(0U, Store->getNumExtended());
+
+  // The second file uses the preamble of the first one as is, so the header
+  // is not read again.
+  unsigned Header1ReadCount = GetFileReadCount(Header1);
+  std::unique_ptr<ASTUnit> SecondAST = ParseASTWithPreambleStore(Second, Store);
+  ASSERT_TRUE(SecondAST.get());
+  ASSERT_FALSE(SecondAST->getDiagnostics().hasErrorOccurred());
+  EXPECT_EQ(1U, Store->getNumReused());
+  EXPECT_EQ(0U, Store->getNumExtended());
+  EXPECT_EQ(Header1ReadCount, GetFileReadCount(Header1));
+
+  // The third file only parses the part of its preamble that follows the
+  // shared one.
+  std::unique_ptr<ASTUnit> ThirdAST = ParseASTWithPreambleStore(Third, Store);
+  ASSERT_TRUE(ThirdAST.get());
+  ASSERT_FALSE(ThirdAST->getDiagnostics().hasErrorOccurred());
+  EXPECT_EQ(1U, Store->getNumReused());
+  EXPECT_EQ(1U, Store->getNumExtended());
+}
+
+TEST_F(PCHPreambleTest, SharePreambleOnlyWithinDirectory) {
+  std::string FirstHeader = "//./first/header.h";
+  std::string SecondHeader = "//./second/header.h";
+  std::string First = "//./first/main.cpp";
+  std::string Second = "//./second/main.cpp";
+  AddFile(FirstHeader, "int a;\n");
+  AddFile(SecondHeader, "int b;\n");
+  // The same preamble text includes a different header in each directory.
+  AddFile(First, "#include \"header.h\"\n"
+                 "int main() { return a; }");
+  AddFile(Second, "#include \"header.h\"\n"
+                  "int main() { return b; }");
+
+  auto Store = std::make_shared<PreambleStore>();
+  std::unique_ptr<ASTUnit> FirstAST = ParseASTWithPreambleStore(First, Store);
+  ASSERT_TRUE(FirstAST.get());
+  ASSERT_FALSE(FirstAST->getDiagnostics().hasErrorOccurred());
+
+  std::unique_ptr<ASTUnit> SecondAST = ParseASTWithPreambleStore(Second, Store);
+  ASSERT_TRUE(SecondAST.get());
+  EXPECT_FALSE(SecondAST->getDiagnostics().hasErrorOccurred());
+  EXPECT_EQ(0U, Store->getNumReused());
+  EXPECT_EQ(0U, Store->getNumExtended());
+}
+
 } // anonymous namespace
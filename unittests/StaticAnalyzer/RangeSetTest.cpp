@@ -0,0 +1,89 @@
+//===- unittests/StaticAnalyzer/RangeSetTest.cpp - RangeSet tests ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/StaticAnalyzer/Core/PathSensitive/BasicValueFactory.h"
+#include "clang/StaticAnalyzer/Core/PathSensitive/RangedConstraintManager.h"
+#include "clang/Tooling/Tooling.h"
+#include "gtest/gtest.h"
+
+namespace clang {
+namespace ento {
+namespace {
+
+class RangeSetTest : public testing::Test {
+protected:
+  std::unique_ptr<ASTUnit> AST = tooling::buildASTFromCode("");
+  llvm::BumpPtrAllocator Alloc;
+  BasicValueFactory BVF{AST->getASTContext(), Alloc};
+  RangeSet::Factory F;
+
+  const llvm::APSInt &value(int64_t X) {
+    return BVF.getValue(llvm::APSInt::get(X).extOrTrunc(8));
+  }
+
+  RangeSet set(std::initializer_list<std::pair<int64_t, int64_t>> Ranges) {
+    RangeSet::ContainerType Result;
+    for (const auto &R : Ranges)
+      Result.push_back(Range(value(R.first), value(R.second)));
+    return F.getRangeSet(std::move(Result));
+  }
+};
+
+TEST_F(RangeSetTest, SetsAreUniqued) {
+  EXPECT_EQ(set({{1, 2}, {5, 7}}), set({{5, 7}, {1, 2}}));
+  EXPECT_FALSE(set({{1, 2}}) == set({{1, 3}}));
+  EXPECT_EQ(F.getEmptySet(), set({}));
+  EXPECT_TRUE(F.getEmptySet().isEmpty());
+
+  llvm::FoldingSetNodeID First, Second;
+  set({{1, 2}, {5, 7}}).Profile(First);
+  set({{5, 7}, {1, 2}}).Profile(Second);
+  EXPECT_EQ(First, Second);
+}
+
+TEST_F(RangeSetTest, Intersect) {
+  RangeSet RS = set({{-10, -5}, {0, 10}, {20, 30}});
+  EXPECT_EQ(set({{-7, -5}, {0, 3}}),
+            RS.Intersect(BVF, F, value(-7), value(3)));
+  EXPECT_TRUE(RS.Intersect(BVF, F, value(11), value(19)).isEmpty());
+
+  // Lower > Upper wraps around and removes the values in between.
+  EXPECT_EQ(set({{-10, -5}, {0, 2}, {25, 30}}),
+            RS.Intersect(BVF, F, value(25), value(2)));
+
+  // Intersecting with a single value yields a concrete value.
+  const llvm::APSInt *Concrete =
+      RS.Intersect(BVF, F, value(7), value(7)).getConcreteValue();
+  ASSERT_TRUE(Concrete);
+  EXPECT_EQ(7, Concrete->getExtValue());
+  EXPECT_FALSE(RS.getConcreteValue());
+}
+
+TEST_F(RangeSetTest, Negate) {
+  EXPECT_EQ(set({{-10, -5}, {3, 7}}),
+            set({{-7, -3}, {5, 10}}).Negate(BVF, F));
+
+  // [MIN, B] turns into [MIN, MIN] U [-B, MAX].
+  EXPECT_EQ(set({{-128, -128}, {-5, 127}}), set({{-128, 5}}).Negate(BVF, F));
+
+  // [MIN, MIN] U [A, MAX] turns into [MIN, -A].
+  EXPECT_EQ(set({{-128, -10}}), set({{-128, -128}, {10, 127}}).Negate(BVF, F));
+}
+
+TEST_F(RangeSetTest, AddRange) {
+  RangeSet Low = set({{-10, -5}});
+  RangeSet High = set({{5, 10}, {20, 30}});
+  EXPECT_EQ(set({{-10, -5}, {5, 10}, {20, 30}}), Low.addRange(F, High));
+  EXPECT_EQ(Low.addRange(F, High), High.addRange(F, Low));
+}
+
+} // namespace
+} // namespace ento
+} // namespace clang
@@ -17,6 +17,7 @@
 #include "clang/Tooling/CompilationDatabase.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
@@ -547,6 +548,45 @@ TEST(ClangToolTest, BuildASTs) {
   EXPECT_EQ(2u, ASTs.size());
 }
 
+TEST(ClangToolTest, SharedModuleCache) {
+  SmallString<128> Dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("shared-modules", Dir));
+  auto WriteFile = [&](StringRef Name, StringRef Contents) {
+    SmallString<128> Path(Dir);
+    llvm::sys::path::append(Path, Name);
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(Path, EC, llvm::sys::fs::F_None);
+    ASSERT_FALSE(EC);
+    OS << Contents;
+  };
+  WriteFile("module.modulemap", "module A { header \"a.h\" }");
+  WriteFile("a.h", "int a();");
+  std::vector<std::string> Sources;
+  for (StringRef Name : {"1.cc", "2.cc", "3.cc"}) {
+    WriteFile(Name, "#include \"a.h\"\nint b() { return a(); }");
+    SmallString<128> Path(Dir);
+    llvm::sys::path::append(Path, Name);
+    Sources.push_back(Path.str());
+  }
+
+  FixedCompilationDatabase Compilations(
+      Dir, {"-fmodules", "-fimplicit-module-maps",
+            ("-fmodules-cache-path=" + Dir + "/cache").str()});
+  ClangTool Tool(Compilations, Sources);
+  IntrusiveRefCntPtr<SharedModuleCache> Shared(new SharedModuleCache);
+  Tool.setSharedModuleCache(Shared);
+  std::unique_ptr<FrontendActionFactory> Action(
+      newFrontendActionFactory<SyntaxOnlyAction>());
+  EXPECT_EQ(0, Tool.run(Action.get()));
+
+  // The first file builds the module. The second one reads it and shares it
+  // with the third one.
+  EXPECT_NE(0u, Shared->getTotalSize());
+  EXPECT_LT(0u, Shared->getNumHits());
+
+  llvm::sys::fs::remove_directories(Dir);
+}
+
 struct TestDiagnosticConsumer : public DiagnosticConsumer {
   TestDiagnosticConsumer() : NumDiagnosticsSeen(0) {}
   void HandleDiagnostic(DiagnosticsEngine::Level DiagLevel,
@@ -19,6 +19,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <vector>
 #define DEBUG_TYPE "libclang-test"
 
 TEST(libclang, clang_parseTranslationUnit2_InvalidArgs) {
@@ -702,6 +703,51 @@ TEST_F(LibclangReparseTest, PreprocessorSkippedRanges) {
   }
 }
 
+TEST_F(LibclangReparseTest, SharePreamble) {
+  std::string Header = "header.h", Other = "other.h";
+  WriteFile(Header, "struct Foo { int bar; };\n");
+  WriteFile(Other, "struct Baz { int qux; };\n");
+
+  const char *Prefix = "#include \"header.h\"\n";
+  std::string First = "first.cpp", Second = "second.cpp", Third = "third.cpp";
+  WriteFile(First,
+            std::string(Prefix) + "int first() { Foo f; return f.bar; }\n");
+  WriteFile(Second,
+            std::string(Prefix) + "int second() { Foo f; return f.bar; }\n");
+  // The preamble of this file extends the one of the other files.
+  WriteFile(Third, std::string(Prefix) + "#include \"other.h\"\n"
+                   "int third() { Foo f; Baz b; return f.bar + b.qux; }\n");
+
+  unsigned Flags = TUFlags | CXTranslationUnit_PrecompiledPreamble |
+                   CXTranslationUnit_CreatePreambleOnFirstParse |
+                   CXTranslationUnit_SharePreamble;
+  std::vector<CXTranslationUnit> TUs;
+  for (const std::string &Main : {First, Second, Third, Second}) {
+    ClangTU = clang_parseTranslationUnit(Index, Main.c_str(), nullptr, 0,
+                                         nullptr, 0, Flags);
+    ASSERT_TRUE(ClangTU);
+    EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+    DisplayDiagnostics();
+    ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+    EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+    TUs.push_back(ClangTU);
+  }
+
+  // Each translation unit keeps working once the one that built the preamble
+  // it uses is gone.
+  clang_disposeTranslationUnit(TUs.front());
+  TUs.erase(TUs.begin());
+  for (CXTranslationUnit TU : TUs) {
+    ClangTU = TU;
+    ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+    EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+  }
+
+  for (CXTranslationUnit TU : TUs)
+    if (TU != ClangTU)
+      clang_disposeTranslationUnit(TU);
+}
+
 class LibclangSerializationTest : public LibclangParseTest {
 public:
   bool SaveAndLoadTU(const std::string &Filename) {
@@ -0,0 +1,46 @@
+// RUN: %clang_cpp -c %s
+//
+// A translation unit with thousands of members of class templates nested in
+// namespaces, for measuring the time spent mangling names that share long
+// prefixes (-ftime-report).
+
+namespace project {
+namespace detail {
+namespace v1 {
+template <typename T, int N> struct Table {
+  T Values[N];
+
+  template <int I> T get() const { return Values[I % N]; }
+  template <int I> void set(T Value) { Values[I % N] = Value; }
+};
+} // namespace v1
+} // namespace detail
+} // namespace project
+
+using project::detail::v1::Table;
+
+#define FUNC(n)                                                                \
+  int func##n(Table<int, (n % 8) + 1> &A, Table<long, (n % 4) + 1> &B) {       \
+    A.set<n>(A.get<n + 1>() + 1);                                              \
+    B.set<n>(B.get<n + 2>() + A.get<n>());                                     \
+    return A.get<n>();                                                         \
+  }
+
+#define FUNC10(n)                                                              \
+  FUNC(n##0) FUNC(n##1) FUNC(n##2) FUNC(n##3) FUNC(n##4)                       \
+  FUNC(n##5) FUNC(n##6) FUNC(n##7) FUNC(n##8) FUNC(n##9)
+#define FUNC100(n)                                                             \
+  FUNC10(n##0) FUNC10(n##1) FUNC10(n##2) FUNC10(n##3) FUNC10(n##4)             \
+  FUNC10(n##5) FUNC10(n##6) FUNC10(n##7) FUNC10(n##8) FUNC10(n##9)
+
+FUNC100(1)
+FUNC100(2)
+FUNC100(3)
+FUNC100(4)
+FUNC100(5)
+
+int main() {
+  Table<int, 1> A = {};
+  Table<long, 1> B = {};
+  return func120(A, B);
+}